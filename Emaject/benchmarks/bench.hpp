@@ -0,0 +1,446 @@
+#pragma once
+// Harness shared by the runtime benchmarks.
+// It pulls in the counting operator new, so include it from exactly one translation unit per executable.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../tests/counting_new.hpp"
+
+namespace emaject::bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // heap allocations and requested bytes of the calling thread
+    using counting::t_allocations;
+    using counting::t_allocatedBytes;
+
+    inline const void* volatile g_sink = nullptr;
+
+    /// <summary>
+    /// Keep a value observable so the work producing it isn't optimized away
+    /// </summary>
+    template<class Type>
+    inline void do_not_optimize(const Type& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        g_sink = &value;
+#endif
+    }
+
+    /// <summary>
+    /// Value at quantile q (0..1) of sorted samples
+    /// </summary>
+    template<class Type>
+    inline Type percentile(const std::vector<Type>& sorted, double q)
+    {
+        if (sorted.empty()) {
+            return Type{};
+        }
+        const size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    /// <summary>
+    /// Median and median absolute deviation of samples
+    /// </summary>
+    inline std::pair<double, double> median_mad(std::vector<double> samples)
+    {
+        if (samples.empty()) {
+            return { 0.0, 0.0 };
+        }
+        std::sort(samples.begin(), samples.end());
+        const double median = samples[samples.size() / 2];
+        for (double& sample : samples) {
+            sample = std::abs(sample - median);
+        }
+        std::sort(samples.begin(), samples.end());
+        return { median, samples[samples.size() / 2] };
+    }
+
+    struct Result
+    {
+        /// median ns/op of the samples
+        double nsPerOp = 0;
+        double madNs = 0;
+        double allocsPerOp = 0;
+        /// ns/op of every sample
+        std::vector<double> samples;
+    };
+
+    struct Options
+    {
+        std::chrono::nanoseconds minSampleTime = std::chrono::milliseconds(20);
+        size_t sampleCount = 7;
+    };
+
+    /// <summary>
+    /// Time one operation: the batch size is grown until a sample takes minSampleTime, and the median sample is reported
+    /// </summary>
+    template<class Op>
+    Result measure(Op&& op, const Options& options = {})
+    {
+        auto runBatch = [&](size_t iterations) {
+            const auto begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                if constexpr (std::is_void_v<decltype(op())>) {
+                    op();
+                } else {
+                    do_not_optimize(op());
+                }
+            }
+            return Clock::now() - begin;
+        };
+        size_t iterations = 1;
+        while (runBatch(iterations) < options.minSampleTime / 4 && iterations < (size_t{ 1 } << 40)) {
+            iterations *= 2;
+        }
+        iterations *= 4;
+
+        Result result;
+        const size_t allocations = t_allocations;
+        for (size_t i = 0; i < options.sampleCount; ++i) {
+            const std::chrono::duration<double, std::nano> elapsed = runBatch(iterations);
+            result.samples.push_back(elapsed.count() / static_cast<double>(iterations));
+        }
+        result.allocsPerOp = static_cast<double>(t_allocations - allocations) / static_cast<double>(iterations * options.sampleCount);
+        std::tie(result.nsPerOp, result.madNs) = median_mad(result.samples);
+        return result;
+    }
+
+    /// <summary>
+    /// Recorded result of one case
+    /// </summary>
+    struct Baseline
+    {
+        double nsPerOp = 0;
+        double madNs = 0;
+        double allocsPerOp = 0;
+    };
+
+    /// <summary>
+    /// Parser of the baseline JSON: an object mapping case names to objects of numbers
+    /// Whitespace and member order are free, so a reformatted baseline still reads.
+    /// </summary>
+    class BaselineParser
+    {
+    public:
+        explicit BaselineParser(std::string_view text) :
+            m_text(text)
+        {}
+
+        /// <returns>false with error() set if the text isn't a valid baseline</returns>
+        bool parse(std::map<std::string, Baseline>& out)
+        {
+            if (!this->expect('{')) {
+                return false;
+            }
+            if (!this->consume('}')) {
+                do {
+                    std::string name;
+                    Baseline baseline;
+                    if (!this->string(name) || !this->expect(':') || !this->entry(baseline)) {
+                        return false;
+                    }
+                    if (!out.emplace(std::move(name), baseline).second) {
+                        return this->fail("duplicate case");
+                    }
+                } while (this->consume(','));
+                if (!this->expect('}')) {
+                    return false;
+                }
+            }
+            this->skipSpace();
+            return m_pos == m_text.size() || this->fail("trailing characters");
+        }
+        [[nodiscard]] const std::string& error() const
+        {
+            return m_error;
+        }
+    private:
+        bool entry(Baseline& out)
+        {
+            bool median = false, mad = false, allocs = false;
+            if (!this->expect('{')) {
+                return false;
+            }
+            do {
+                std::string key;
+                double value = 0;
+                if (!this->string(key) || !this->expect(':') || !this->number(value)) {
+                    return false;
+                }
+                if (key == "median_ns") {
+                    out.nsPerOp = value;
+                    median = true;
+                } else if (key == "mad_ns") {
+                    out.madNs = value;
+                    mad = true;
+                } else if (key == "allocs") {
+                    out.allocsPerOp = value;
+                    allocs = true;
+                } else {
+                    return this->fail("unknown key \"" + key + "\"");
+                }
+            } while (this->consume(','));
+            if (!this->expect('}')) {
+                return false;
+            }
+            return (median && mad && allocs) || this->fail("case needs median_ns, mad_ns and allocs");
+        }
+        bool string(std::string& out)
+        {
+            if (!this->expect('"')) {
+                return false;
+            }
+            while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                char c = m_text[m_pos++];
+                if (c == '\\') {
+                    if (m_pos == m_text.size()) {
+                        break;
+                    }
+                    c = m_text[m_pos++];
+                    if (c != '"' && c != '\\' && c != '/') {
+                        return this->fail("unsupported escape");
+                    }
+                }
+                out.push_back(c);
+            }
+            return this->expect('"');
+        }
+        bool number(double& out)
+        {
+            this->skipSpace();
+            const std::string rest(m_text.substr(m_pos, 64));
+            char* end = nullptr;
+            out = std::strtod(rest.c_str(), &end);
+            if (end == rest.c_str()) {
+                return this->fail("expected a number");
+            }
+            m_pos += static_cast<size_t>(end - rest.c_str());
+            return true;
+        }
+        bool consume(char c)
+        {
+            this->skipSpace();
+            if (m_pos < m_text.size() && m_text[m_pos] == c) {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+        bool expect(char c)
+        {
+            return this->consume(c) || this->fail(std::string("expected '") + c + "'");
+        }
+        void skipSpace()
+        {
+            while (m_pos < m_text.size() && std::string_view(" \t\r\n").find(m_text[m_pos]) != std::string_view::npos) {
+                ++m_pos;
+            }
+        }
+        bool fail(const std::string& message)
+        {
+            if (m_error.empty()) {
+                m_error = message + " at offset " + std::to_string(m_pos);
+            }
+            return false;
+        }
+    private:
+        std::string_view m_text;
+        size_t m_pos = 0;
+        std::string m_error;
+    };
+
+    /// <summary>
+    /// Read a baseline written by write_baseline
+    /// </summary>
+    inline bool read_baseline(const char* path, std::map<std::string, Baseline>& out, std::string& error)
+    {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            error = "can't open the file";
+            return false;
+        }
+        std::string text;
+        char buffer[4096];
+        while (size_t read = std::fread(buffer, 1, sizeof(buffer), file)) {
+            text.append(buffer, read);
+        }
+        std::fclose(file);
+
+        BaselineParser parser(text);
+        if (!parser.parse(out)) {
+            error = parser.error();
+            return false;
+        }
+        return true;
+    }
+
+    inline bool write_baseline(const char* path, const std::map<std::string, Baseline>& results)
+    {
+        std::FILE* file = std::fopen(path, "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "{\n");
+        size_t i = 0;
+        for (const auto& [name, r] : results) {
+            std::string escaped;
+            for (char c : name) {
+                if (c == '"' || c == '\\') {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(c);
+            }
+            std::fprintf(file, "  \"%s\": { \"median_ns\": %.3f, \"mad_ns\": %.3f, \"allocs\": %.3f }%s\n",
+                escaped.c_str(), r.nsPerOp, r.madNs, r.allocsPerOp, ++i < results.size() ? "," : "");
+        }
+        std::fprintf(file, "}\n");
+        return std::fclose(file) == 0;
+    }
+
+    /// <summary>
+    /// Run cases side by side with the hand-written wiring they replace
+    /// usage: [filter] [--samples N] [--record baseline.json] [--compare baseline.json] [--threshold 0.05]
+    /// filter selects cases by substring of "group/name".
+    /// --record writes the results, --compare fails cases slower than the baseline by more than
+    /// the threshold and the noise (3 MADs), or that allocate more. A baseline that doesn't parse,
+    /// is empty, or doesn't list the same cases as the run also fails.
+    /// </summary>
+    class Runner
+    {
+    public:
+        Runner(int argc, char** argv)
+        {
+            for (int i = 1; i < argc; ++i) {
+                const bool hasValue = i + 1 < argc;
+                if (std::strcmp(argv[i], "--samples") == 0 && hasValue) {
+                    m_options.sampleCount = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+                } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+                    m_recordPath = argv[++i];
+                } else if (std::strcmp(argv[i], "--compare") == 0 && hasValue) {
+                    m_comparePath = argv[++i];
+                } else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue) {
+                    m_threshold = std::strtod(argv[++i], nullptr);
+                } else {
+                    m_filter = argv[i];
+                }
+            }
+            if (!m_comparePath.empty()) {
+                std::string error;
+                if (!read_baseline(m_comparePath.c_str(), m_baseline, error)) {
+                    std::fprintf(stderr, "can't read baseline %s: %s\n", m_comparePath.c_str(), error.c_str());
+                    m_failed = true;
+                } else if (m_baseline.empty()) {
+                    std::fprintf(stderr, "baseline %s has no cases\n", m_comparePath.c_str());
+                    m_failed = true;
+                }
+            }
+            std::printf("%-14s %-22s %12s %9s %12s %9s %8s\n", "group", "case", "emaject ns", "allocs", "manual ns", "allocs", "ratio");
+        }
+
+        /// <summary>
+        /// Write the record and report the comparison
+        /// </summary>
+        /// <returns>process exit code: non-zero on a regression or a file error</returns>
+        int finish()
+        {
+            if (!m_recordPath.empty()) {
+                if (write_baseline(m_recordPath.c_str(), m_results)) {
+                    std::printf("recorded %zu cases to %s\n", m_results.size(), m_recordPath.c_str());
+                } else {
+                    std::fprintf(stderr, "can't write baseline %s\n", m_recordPath.c_str());
+                    m_failed = true;
+                }
+            }
+            if (!m_comparePath.empty() && !m_failed) {
+                // every case run must have a baseline, and every baseline case selected by the filter must have run
+                size_t missing = 0;
+                for (const auto& [name, r] : m_results) {
+                    if (!m_baseline.contains(name)) {
+                        std::fprintf(stderr, "%s: not in the baseline\n", name.c_str());
+                        ++missing;
+                    }
+                }
+                for (const auto& [name, r] : m_baseline) {
+                    if (name.find(m_filter) != std::string::npos && !m_results.contains(name)) {
+                        std::fprintf(stderr, "%s: in the baseline but not measured\n", name.c_str());
+                        ++missing;
+                    }
+                }
+                if (m_results.empty() || missing > 0) {
+                    std::fprintf(stderr, "%zu cases missing on either side; record a new baseline if cases changed\n", missing);
+                    m_failed = true;
+                }
+                std::printf("%zu regressions against %s\n", m_regressions, m_comparePath.c_str());
+            }
+            return m_failed || m_regressions > 0 ? 1 : 0;
+        }
+
+        template<class Emaject, class Manual>
+        void compare(std::string_view group, std::string_view name, Emaject&& emaject, Manual&& manual)
+        {
+            std::string id = std::string(group) + "/" + std::string(name);
+            if (id.find(m_filter) == std::string::npos) {
+                return;
+            }
+            const Result di = measure(std::forward<Emaject>(emaject), m_options);
+            const Result hand = measure(std::forward<Manual>(manual), m_options);
+            std::printf(
+                "%-14.*s %-22.*s %12.2f %9.2f %12.2f %9.2f %7.2fx\n",
+                static_cast<int>(group.size()), group.data(),
+                static_cast<int>(name.size()), name.data(),
+                di.nsPerOp, di.allocsPerOp,
+                hand.nsPerOp, hand.allocsPerOp,
+                hand.nsPerOp > 0 ? di.nsPerOp / hand.nsPerOp : 0.0
+            );
+            m_results[id] = Baseline{ di.nsPerOp, di.madNs, di.allocsPerOp };
+            if (auto itr = m_baseline.find(id); itr != m_baseline.end()) {
+                this->check(itr->second, di);
+            }
+            std::fflush(stdout);
+        }
+    private:
+        void check(const Baseline& base, const Result& current)
+        {
+            // 1.4826 * MAD estimates the standard deviation of normally distributed samples
+            const double noise = 3.0 * 1.4826 * std::hypot(base.madNs, current.madNs);
+            const double delta = current.nsPerOp - base.nsPerOp;
+            const bool slower = delta > base.nsPerOp * m_threshold && delta > noise;
+            const bool allocates = current.allocsPerOp > base.allocsPerOp + 0.01;
+            std::printf("%-37s %12.2f %9.2f %+11.1f%% %s\n",
+                "  baseline", base.nsPerOp, base.allocsPerOp,
+                base.nsPerOp > 0 ? 100.0 * delta / base.nsPerOp : 0.0,
+                slower || allocates ? "REGRESSION" : "ok"
+            );
+            if (slower || allocates) {
+                ++m_regressions;
+            }
+        }
+    private:
+        std::string m_filter;
+        Options m_options;
+        std::string m_recordPath;
+        std::string m_comparePath;
+        double m_threshold = 0.05;
+        std::map<std::string, Baseline> m_baseline;
+        std::map<std::string, Baseline> m_results;
+        size_t m_regressions = 0;
+        bool m_failed = false;
+    };
+}
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Compile-time benchmark of the INJECT / AutoInjector machinery.
+
+Generates synthetic translation units that vary one axis at a time around a base case:
+the number of injectable classes, INJECT fields per class, the line the classes start at
+and the arity of an INJECT method. Each unit is compiled with every given compiler and the
+wall time and peak compiler memory are recorded (Linux only: memory comes from wait4).
+"""
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+BASE = {"classes": 20, "fields": 2, "line": 100, "arity": 2}
+AXES = {
+    "classes": [1, 20, 50],
+    "fields": [1, 2, 8],
+    "line": [100, 10000, 1000000],
+    "arity": [0, 2, 8],
+}
+DEPENDENCIES = 8
+
+
+def cases():
+    yield "header", None
+    seen = set()
+    for axis, values in AXES.items():
+        for value in values:
+            case = dict(BASE, **{axis: value})
+            key = tuple(case.values())
+            if key in seen:
+                continue
+            seen.add(key)
+            yield axis, case
+
+
+def generate(case):
+    """Source of one synthetic translation unit; None is the header alone"""
+    lines = ["#include <Emaject.hpp>", ""]
+    if case is None:
+        lines.append("int main() {}")
+        return "\n".join(lines) + "\n"
+
+    for d in range(DEPENDENCIES):
+        lines.append(f"struct Dep{d} {{}};")
+    lines.append("")
+    # INJECTs must stay on distinct lines, so only the first class is moved
+    lines.append(f"#line {case['line']}")
+    for c in range(case["classes"]):
+        lines.append(f"class Class{c}")
+        lines.append("{")
+        lines.append("public:")
+        for f in range(case["fields"]):
+            lines.append(f"    [[INJECT(field{f})]]")
+            lines.append(f"    std::shared_ptr<Dep{f % DEPENDENCIES}> field{f};")
+        if case["arity"] > 0:
+            params = ", ".join(
+                f"std::shared_ptr<Dep{a % DEPENDENCIES}>" for a in range(case["arity"])
+            )
+            lines.append("    [[INJECT(setup)]]")
+            lines.append(f"    void setup({params}) {{}}")
+        lines.append("};")
+    lines.append("")
+    lines.append("int main()")
+    lines.append("{")
+    lines.append("    emaject::Injector injector;")
+    lines.append("    injector.install([](emaject::Container* c) {")
+    for d in range(DEPENDENCIES):
+        lines.append(f"        c->bind<Dep{d}>().asCached();")
+    lines.append("    });")
+    for c in range(case["classes"]):
+        lines.append(f"    (void)injector.instantiate<Class{c}>();")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def compile_once(cxx, flags, include, source):
+    """(seconds, peak KiB) of one compiler run"""
+    command = [cxx, *flags, f"-I{include}", "-c", source, "-o", os.devnull]
+    # a file rather than a pipe: a compiler filling the pipe buffer would block while we wait for it
+    with tempfile.TemporaryFile() as log:
+        begin = time.perf_counter()
+        process = subprocess.Popen(command, stderr=log)
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - begin
+        process.returncode = os.waitstatus_to_exitcode(status)
+        log.seek(0)
+        stderr = log.read().decode(errors="replace")
+    if process.returncode != 0:
+        raise RuntimeError(f"{' '.join(command)} failed:\n{stderr}")
+    return elapsed, usage.ru_maxrss
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cxx", action="append", help="compiler to measure; may be repeated (default: c++)")
+    parser.add_argument("--include", default=os.path.join(here, "..", "include"), help="directory of Emaject.hpp")
+    parser.add_argument("--flags", default="-std=c++20 -O0", help="compiler flags")
+    parser.add_argument("--repeat", type=int, default=1, help="runs per case; the fastest is reported")
+    parser.add_argument("--csv", help="also write the results to this file")
+    args = parser.parse_args()
+
+    compilers = args.cxx or ["c++"]
+    flags = args.flags.split()
+    rows = []
+    print(f"{'compiler':<12} {'axis':<8} {'classes':>7} {'fields':>6} {'line':>7} {'arity':>5} {'seconds':>8} {'peak MiB':>9}")
+    with tempfile.TemporaryDirectory() as work:
+        for axis, case in cases():
+            source = os.path.join(work, "unit.cpp")
+            with open(source, "w") as f:
+                f.write(generate(case))
+            params = case or {key: 0 for key in BASE}
+            for cxx in compilers:
+                runs = [compile_once(cxx, flags, args.include, source) for _ in range(args.repeat)]
+                seconds = min(r[0] for r in runs)
+                peak = max(r[1] for r in runs)
+                rows.append({"compiler": os.path.basename(cxx), "axis": axis, **params, "seconds": seconds, "peak_kib": peak})
+                print(
+                    f"{os.path.basename(cxx):<12} {axis:<8} {params['classes']:>7} {params['fields']:>6}"
+                    f" {params['line']:>7} {params['arity']:>5} {seconds:>8.2f} {peak / 1024:>9.1f}",
+                    flush=True,
+                )
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()))
+            writer.writeheader()
+            writer.writerows(rows)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
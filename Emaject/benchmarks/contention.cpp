@@ -0,0 +1,259 @@
+#include <Emaject.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <latch>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::Injector;
+    using emaject::bench::Clock;
+    using emaject::bench::do_not_optimize;
+    using emaject::bench::percentile;
+
+    constexpr size_t DisjointCount = 16;
+
+    struct Config
+    {
+        int value = 1;
+    };
+
+    class IService
+    {
+    public:
+        virtual ~IService() = default;
+        virtual int work() const = 0;
+    };
+
+    class Service : public IService
+    {
+    public:
+        int work() const override
+        {
+            return config ? config->value : 0;
+        }
+
+        [[INJECT(config)]]
+        std::shared_ptr<Config> config;
+    };
+
+    class Client
+    {
+    public:
+        [[INJECT(service)]]
+        std::shared_ptr<IService> service;
+    };
+
+    struct Settings
+    {
+        size_t maxThreads = 1;
+        size_t ops = 200'000;
+        bool stress = false;
+    };
+
+    struct Report
+    {
+        double mops = 0;
+        double meanNs = 0;
+        uint32_t p50 = 0;
+        uint32_t p99 = 0;
+        uint32_t p999 = 0;
+    };
+
+    /// <summary>
+    /// Every thread runs op(threadIndex) ops times after a common start
+    /// Latencies are per op and include the cost of reading the clock.
+    /// </summary>
+    template<class Op>
+    Report run(size_t threads, size_t ops, Op&& op)
+    {
+        std::vector<std::vector<uint32_t>> latencies(threads, std::vector<uint32_t>(ops));
+        std::latch start(static_cast<std::ptrdiff_t>(threads + 1));
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                auto& out = latencies[t];
+                start.arrive_and_wait();
+                for (size_t i = 0; i < ops; ++i) {
+                    const auto begin = Clock::now();
+                    do_not_optimize(op(t));
+                    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+                    out[i] = static_cast<uint32_t>(std::min<int64_t>(elapsed, UINT32_MAX));
+                }
+            });
+        }
+        start.arrive_and_wait();
+        const auto begin = Clock::now();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const std::chrono::duration<double, std::micro> wall = Clock::now() - begin;
+
+        std::vector<uint32_t> all;
+        all.reserve(threads * ops);
+        for (const auto& out : latencies) {
+            all.insert(all.end(), out.begin(), out.end());
+        }
+        std::sort(all.begin(), all.end());
+        double sum = 0;
+        for (uint32_t ns : all) {
+            sum += ns;
+        }
+        Report report;
+        report.mops = static_cast<double>(all.size()) / wall.count();
+        report.meanNs = all.empty() ? 0 : sum / static_cast<double>(all.size());
+        report.p50 = percentile(all, 0.5);
+        report.p99 = percentile(all, 0.99);
+        report.p999 = percentile(all, 0.999);
+        return report;
+    }
+
+    template<size_t... Indices>
+    auto disjoint_table(std::index_sequence<Indices...>)
+    {
+        using Resolve = std::shared_ptr<IService>(*)(Injector&);
+        return std::array<Resolve, sizeof...(Indices)>{
+            [](Injector& injector) { return injector.resolve<IService, static_cast<int>(Indices)>(); }...
+        };
+    }
+
+    Injector make_injector(const std::function<void(Container*)>& bindService)
+    {
+        Injector injector;
+        injector.install([&](Container* c) {
+            c->bind<Config>()
+                .asCached();
+            bindService(c);
+        });
+        injector.seal();
+        return injector;
+    }
+
+    template<size_t... Indices>
+    void bind_disjoint(Container* c, std::index_sequence<Indices...>)
+    {
+        (c->template bind<IService, static_cast<int>(Indices)>().template to<Service>().asCached(), ...);
+    }
+
+    void bench(const Settings& settings)
+    {
+        std::vector<size_t> threadCounts;
+        for (size_t t = 1; t < settings.maxThreads; t *= 2) {
+            threadCounts.push_back(t);
+        }
+        threadCounts.push_back(settings.maxThreads);
+
+        auto cached = make_injector([](Container* c) {
+            c->bind<IService>().to<Service>().asCached();
+        });
+        auto single = make_injector([](Container* c) {
+            c->bind<IService>().to<Service>().asSingle();
+        });
+        auto transient = make_injector([](Container* c) {
+            c->bind<IService>().to<Service>().asTransient();
+        });
+        auto disjoint = make_injector([](Container* c) {
+            bind_disjoint(c, std::make_index_sequence<DisjointCount>{});
+        });
+        const auto disjointResolve = disjoint_table(std::make_index_sequence<DisjointCount>{});
+        const std::shared_ptr<IService> shared = cached.resolve<IService>();
+
+        std::printf("%-18s %7s %10s %9s %9s %9s\n", "scenario", "threads", "Mops/s", "p50 ns", "p99 ns", "p999 ns");
+        std::map<size_t, double> refcountNs;
+        for (size_t threads : threadCounts) {
+            auto print = [&](const char* name, const Report& r) {
+                std::printf("%-18s %7zu %10.2f %9u %9u %9u\n", name, threads, r.mops, r.p50, r.p99, r.p999);
+                std::fflush(stdout);
+            };
+            // the hand-written equivalent of a Cached resolve: one shared instance copied by every thread
+            print("shared_ptr copy", run(threads, settings.ops, [&](size_t) { return shared; }));
+            const Report owning = run(threads, settings.ops, [&](size_t) { return cached.resolve<IService>(); });
+            print("cached", owning);
+            const Report borrowed = run(threads, settings.ops, [&](size_t) { return cached.resolveBorrowed<IService>(); });
+            print("cached borrowed", borrowed);
+            print("single", run(threads, settings.ops, [&](size_t) { return single.resolve<IService>(); }));
+            print("disjoint cached", run(threads, settings.ops, [&](size_t t) { return disjointResolve[t % DisjointCount](disjoint); }));
+            print("transient", run(threads, settings.ops, [&](size_t) { return transient.resolve<IService>(); }));
+            print("instantiate", run(threads, settings.ops, [&](size_t) { return cached.instantiate<Client>(); }));
+            refcountNs[threads] = owning.meanNs - borrowed.meanNs;
+        }
+
+        // the owning and borrowed resolve differ only by the reference count, so the gap is the cost of sharing its cache line
+        std::printf("\n%-18s %7s %10s\n", "refcount", "threads", "ns/op");
+        for (const auto& [threads, ns] : refcountNs) {
+            std::printf("%-18s %7zu %10.2f\n", "cached - borrowed", threads, ns);
+        }
+    }
+
+    /// <summary>
+    /// Short runs that race first resolves on fresh containers; meant to be run under ThreadSanitizer
+    /// </summary>
+    bool stress(const Settings& settings)
+    {
+        const size_t threads = std::max<size_t>(settings.maxThreads, 4);
+        bool ok = true;
+        for (int round = 0; round < 50; ++round) {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asCached();
+                c->bind<IService, 1>().to<Service>().asTransient();
+            });
+            std::vector<const IService*> seen(threads);
+            std::vector<uint8_t> valid(threads, 1);
+            std::latch start(static_cast<std::ptrdiff_t>(threads));
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    start.arrive_and_wait();
+                    auto first = injector.resolve<IService>();
+                    seen[t] = first.get();
+                    for (size_t i = 0; i < settings.ops; ++i) {
+                        auto instance = (i % 2) ? injector.resolve<IService>() : injector.resolve<IService, 1>();
+                        auto client = injector.instantiate<Client>();
+                        if (!instance || instance->work() != 1 || !client || client->service != first) {
+                            valid[t] = 0;
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (size_t t = 0; t < threads; ++t) {
+                ok = ok && valid[t] && seen[t] && seen[t] == seen[0];
+            }
+        }
+        std::printf("stress %s (%zu threads)\n", ok ? "passed" : "FAILED", threads);
+        return ok;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // contention_bench [--stress] [--threads N] [--ops N]
+    Settings settings;
+    settings.maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stress") == 0) {
+            settings.stress = true;
+            settings.ops = 2'000;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.maxThreads = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            settings.ops = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        }
+    }
+    if (settings.stress) {
+        return stress(settings) ? 0 : 1;
+    }
+    bench(settings);
+    return 0;
+}
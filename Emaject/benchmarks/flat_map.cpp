@@ -0,0 +1,119 @@
+#include <Emaject.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using emaject::detail::FlatMap;
+    using emaject::detail::TypeId;
+
+    using Clock = std::chrono::steady_clock;
+
+    // keeps the result observable so the lookups aren't optimized away
+    volatile size_t g_sink = 0;
+
+    struct Result
+    {
+        double insertNs;
+        double hitNs;
+        double missNs;
+    };
+
+    template<class Map, class Find, class Insert>
+    Result measure(const std::vector<TypeId>& keys, const std::vector<TypeId>& misses, Find find, Insert insert)
+    {
+        constexpr size_t lookups = 4'000'000;
+        Result result{};
+
+        {
+            // rebuild small maps several times so the timer isn't dominated by noise
+            const size_t rounds = std::max<size_t>(1, 100'000 / keys.size());
+            const auto begin = Clock::now();
+            for (size_t round = 0; round < rounds; ++round) {
+                Map map;
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    insert(map, keys[i], i);
+                }
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+            result.insertNs = elapsed.count() / static_cast<double>(keys.size() * rounds);
+        }
+        Map map;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            insert(map, keys[i], i);
+        }
+        std::vector<TypeId> order = keys;
+        std::shuffle(order.begin(), order.end(), std::mt19937_64{ 42 });
+        {
+            size_t sum = 0;
+            const auto begin = Clock::now();
+            for (size_t i = 0, j = 0; i < lookups; ++i) {
+                sum += find(map, order[j]);
+                if (++j == order.size()) {
+                    j = 0;
+                }
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+            g_sink = sum;
+            result.hitNs = elapsed.count() / lookups;
+        }
+        {
+            size_t sum = 0;
+            const auto begin = Clock::now();
+            for (size_t i = 0, j = 0; i < lookups; ++i) {
+                sum += find(map, misses[j]);
+                if (++j == misses.size()) {
+                    j = 0;
+                }
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - begin;
+            g_sink = sum;
+            result.missNs = elapsed.count() / lookups;
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    std::printf("%10s %-14s %12s %12s %12s\n", "bindings", "map", "insert ns", "hit ns", "miss ns");
+
+    for (size_t count : { 10, 1'000, 100'000 }) {
+        // type ids are addresses of distinct variables, so use addresses as keys
+        std::vector<char> storage(count * 2);
+        std::vector<TypeId> keys, misses;
+        for (size_t i = 0; i < count; ++i) {
+            keys.push_back(&storage[i]);
+            misses.push_back(&storage[count + i]);
+        }
+        std::shuffle(misses.begin(), misses.end(), std::mt19937_64{ 7 });
+
+        const Result node = measure<std::unordered_map<TypeId, size_t>>(
+            keys, misses,
+            [](const auto& map, TypeId key) -> size_t {
+                auto itr = map.find(key);
+                return itr != map.end() ? itr->second : 0;
+            },
+            [](auto& map, TypeId key, size_t value) {
+                map.emplace(key, value);
+            }
+        );
+        const Result flat = measure<FlatMap<TypeId, size_t>>(
+            keys, misses,
+            [](const auto& map, TypeId key) -> size_t {
+                const size_t* value = map.find(key);
+                return value ? *value : 0;
+            },
+            [](auto& map, TypeId key, size_t value) {
+                map.tryEmplace(key, value);
+            }
+        );
+        std::printf("%10zu %-14s %12.2f %12.2f %12.2f\n", count, "unordered_map", node.insertNs, node.hitNs, node.missNs);
+        std::printf("%10zu %-14s %12.2f %12.2f %12.2f\n", count, "FlatMap", flat.insertNs, flat.hitNs, flat.missNs);
+    }
+}
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""Scaling benchmark over large synthetic dependency graphs.
+
+For every graph size a program is generated with one interface and one implementation per node:
+- injection alternates between INJECT fields, INJECT_CTOR and InjectTraits
+- scopes mix Transient, Single and Cached
+- every node depends on its predecessor within chains of --chain nodes and on a parent in a
+  tree of --fanout children, and every 97th node aggregates --fanout nodes spread over the graph
+The nodes are split over several translation units, like a real application.
+
+The program reports registration time and allocations, first-resolve and steady-state resolve
+time of every node. The scaling exponent between consecutive sizes (1.0 is linear) is printed
+for each metric; --check exits non-zero when one exceeds --max-exponent.
+"""
+
+import argparse
+import concurrent.futures
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+CHUNK = 100
+
+
+def dependencies(i, chain, fanout):
+    deps = []
+    if i % chain != 0:
+        deps.append(i - 1)
+    if i > 0:
+        deps.append((i - 1) // fanout)
+    if i % 97 == 96:
+        step = max(1, i // fanout)
+        deps.extend(range(0, i, step))
+    return sorted(set(deps))
+
+
+def scope(i):
+    if i % 5 == 0:
+        return "asTransient()"
+    if i % 5 == 1:
+        return "asSingle()"
+    return "asCached()"
+
+
+def generate_interfaces(nodes):
+    lines = ["#pragma once", "#include <Emaject.hpp>", "", "namespace graph", "{"]
+    for i in range(nodes):
+        lines.append(f"    struct I{i} {{ virtual ~I{i}() = default; virtual int value() const = 0; }};")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def generate_chunk(first, last, chain, fanout):
+    """Implementations, bindings and resolves of nodes [first, last)"""
+    k = first // CHUNK
+    lines = ['#include "interfaces.hpp"', "", f"namespace graph::chunk{k}", "{"]
+    traits = []
+    for i in range(first, last):
+        deps = dependencies(i, chain, fanout)
+        lines.append(f"    class C{i} : public I{i}")
+        lines.append("    {")
+        lines.append("    public:")
+        style = i % 3
+        if style == 1 and deps:
+            params = ", ".join(f"std::shared_ptr<I{d}> p{d}" for d in deps)
+            inits = ", ".join(f"d{d}(std::move(p{d}))" for d in deps)
+            lines.append(f"        INJECT_CTOR(C{i}({params})) : {inits} {{}}")
+        elif style == 2 and deps:
+            traits.append((i, deps))
+        for d in deps:
+            if style == 0:
+                lines.append(f"        [[INJECT(d{d})]]")
+            lines.append(f"        std::shared_ptr<I{d}> d{d};")
+        lines.append("        int value() const override { return 1; }")
+        lines.append("    };")
+    lines.append("}")
+    for i, deps in traits:
+        lines.append("template<>")
+        lines.append(f"struct emaject::InjectTraits<graph::chunk{k}::C{i}>")
+        lines.append("{")
+        lines.append(f"    void onInject(graph::chunk{k}::C{i}* value, emaject::Container* c)")
+        lines.append("    {")
+        for d in deps:
+            lines.append(f"        value->d{d} = c->resolve<graph::I{d}>();")
+        lines.append("    }")
+        lines.append("};")
+    lines.append("")
+    lines.append("namespace graph")
+    lines.append("{")
+    lines.append(f"    void install{k}(emaject::Container* c)")
+    lines.append("    {")
+    for i in range(first, last):
+        lines.append(f"        c->bind<I{i}>().to<chunk{k}::C{i}>().{scope(i)};")
+    lines.append("    }")
+    lines.append(f"    size_t resolve{k}(emaject::Injector& injector)")
+    lines.append("    {")
+    lines.append("        size_t resolved = 0;")
+    for i in range(first, last):
+        lines.append(f"        resolved += injector.resolve<I{i}>() != nullptr;")
+    lines.append("        return resolved;")
+    lines.append("    }")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def generate_main(nodes):
+    chunks = range((nodes + CHUNK - 1) // CHUNK)
+    lines = ['#include "interfaces.hpp"', '#include "bench.hpp"', "", "#include <algorithm>", "#include <cstdio>", "", "namespace graph", "{"]
+    for k in chunks:
+        lines.append(f"    void install{k}(emaject::Container* c);")
+        lines.append(f"    size_t resolve{k}(emaject::Injector& injector);")
+    lines.append("}")
+    lines.append(f"""
+namespace
+{{
+    using emaject::bench::Clock;
+    using emaject::bench::t_allocatedBytes;
+    using emaject::bench::t_allocations;
+
+    constexpr size_t Nodes = {nodes};
+    constexpr int Repeats = 15;
+
+    void install(emaject::Injector& injector)
+    {{
+        injector.install([](emaject::Container* c) {{
+{chr(10).join(f"            graph::install{k}(c);" for k in chunks)}
+        }});
+        injector.seal();
+    }}
+    size_t resolve(emaject::Injector& injector)
+    {{
+        size_t resolved = 0;
+{chr(10).join(f"        resolved += graph::resolve{k}(injector);" for k in chunks)}
+        return resolved;
+    }}
+    double elapsed_ns(Clock::time_point begin)
+    {{
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    }}
+    double median(std::vector<double> values)
+    {{
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }}
+}}
+
+int main()
+{{
+    std::vector<double> registration, first, steady;
+    size_t allocations = 0, bytes = 0;
+    bool ok = true;
+    for (int r = 0; r < Repeats; ++r) {{
+        const size_t allocationsBefore = t_allocations;
+        const size_t bytesBefore = t_allocatedBytes;
+        auto begin = Clock::now();
+        emaject::Injector injector;
+        install(injector);
+        registration.push_back(elapsed_ns(begin));
+        allocations = t_allocations - allocationsBefore;
+        bytes = t_allocatedBytes - bytesBefore;
+
+        begin = Clock::now();
+        ok = resolve(injector) == Nodes && ok;
+        first.push_back(elapsed_ns(begin));
+
+        begin = Clock::now();
+        for (int pass = 0; pass < 10; ++pass) {{
+            ok = resolve(injector) == Nodes && ok;
+        }}
+        steady.push_back(elapsed_ns(begin) / 10);
+    }}
+    std::printf(
+        "ok=%d register_ns=%.0f register_allocs=%zu register_bytes=%zu first_resolve_ns=%.0f steady_resolve_ns=%.0f\\n",
+        ok, median(registration), allocations, bytes, median(first), median(steady)
+    );
+    return ok ? 0 : 1;
+}}
+""")
+    return "\n".join(lines)
+
+
+def compile_sources(cxx, flags, includes, sources, output, jobs):
+    objects = [source + ".o" for source in sources]
+
+    def compile_one(pair):
+        source, obj = pair
+        subprocess.run([cxx, *flags, *(f"-I{i}" for i in includes), "-c", source, "-o", obj], check=True)
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as pool:
+        list(pool.map(compile_one, zip(sources, objects)))
+    subprocess.run([cxx, *flags, *objects, "-o", output, "-pthread"], check=True)
+
+
+def run(program):
+    # a file rather than a pipe: the program filling the pipe buffer would block while we wait for it
+    with tempfile.TemporaryFile() as log:
+        process = subprocess.Popen([program], stdout=log)
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = os.waitstatus_to_exitcode(status)
+        log.seek(0)
+        out = log.read().decode()
+    if process.returncode != 0:
+        raise RuntimeError(f"{program} failed: {out}")
+    metrics = {key: float(value) for key, value in (item.split("=") for item in out.split())}
+    metrics["peak_kib"] = usage.ru_maxrss
+    return metrics
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--sizes", default="100,300,1000,3000", help="comma separated node counts")
+    parser.add_argument("--chain", type=int, default=64, help="length of dependency chains")
+    parser.add_argument("--fanout", type=int, default=8, help="children per tree node and dependencies of aggregators")
+    parser.add_argument("--cxx", default="c++", help="compiler")
+    parser.add_argument("--include", default=os.path.join(here, "..", "include"), help="directory of Emaject.hpp")
+    parser.add_argument("--flags", default="-std=c++20 -O2", help="compiler flags")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1, help="parallel compiles")
+    parser.add_argument("--keep", help="write the generated sources to this directory instead of a temporary one")
+    parser.add_argument("--check", action="store_true", help="exit non-zero on superlinear scaling")
+    parser.add_argument("--max-exponent", type=float, default=1.3, help="largest scaling exponent accepted by --check")
+    args = parser.parse_args()
+
+    sizes = sorted(int(size) for size in args.sizes.split(","))
+    flags = args.flags.split()
+    results = []
+    with tempfile.TemporaryDirectory() as temp:
+        for nodes in sizes:
+            work = os.path.join(args.keep or temp, f"graph{nodes}")
+            os.makedirs(work, exist_ok=True)
+            with open(os.path.join(work, "interfaces.hpp"), "w") as f:
+                f.write(generate_interfaces(nodes))
+            sources = []
+            for first in range(0, nodes, CHUNK):
+                sources.append(os.path.join(work, f"chunk{first // CHUNK}.cpp"))
+                with open(sources[-1], "w") as f:
+                    f.write(generate_chunk(first, min(first + CHUNK, nodes), args.chain, args.fanout))
+            sources.append(os.path.join(work, "main.cpp"))
+            with open(sources[-1], "w") as f:
+                f.write(generate_main(nodes))
+            print(f"building {nodes} nodes...", file=sys.stderr, flush=True)
+            program = os.path.join(work, "graph")
+            compile_sources(args.cxx, flags, [args.include, here, work], sources, program, args.jobs)
+            results.append((nodes, run(program)))
+
+    print(f"{'nodes':>6} {'register us':>12} {'ns/binding':>11} {'allocs':>8} {'KiB':>9} {'first us':>10} {'steady ns/op':>13} {'peak MiB':>9}")
+    for nodes, m in results:
+        print(
+            f"{nodes:>6} {m['register_ns'] / 1000:>12.1f} {m['register_ns'] / nodes:>11.1f} {m['register_allocs']:>8.0f}"
+            f" {m['register_bytes'] / 1024:>9.1f} {m['first_resolve_ns'] / 1000:>10.1f}"
+            f" {m['steady_resolve_ns'] / nodes:>13.1f} {m['peak_kib'] / 1024:>9.1f}"
+        )
+
+    # exponent k of t ~ n^k between consecutive sizes
+    metrics = ["register_ns", "register_allocs", "register_bytes", "first_resolve_ns", "steady_resolve_ns"]
+    print()
+    print(f"{'exponent':<14}" + "".join(f"{name:>19}" for name in metrics))
+    failed = False
+    for (n0, m0), (n1, m1) in zip(results, results[1:]):
+        exponents = [math.log(max(m1[name], 1) / max(m0[name], 1)) / math.log(n1 / n0) for name in metrics]
+        marks = ["*" if e > args.max_exponent else " " for e in exponents]
+        failed = failed or any(e > args.max_exponent for e in exponents)
+        print(f"{f'{n0}->{n1}':<14}" + "".join(f"{e:>18.2f}{mark}" for e, mark in zip(exponents, marks)))
+    if failed:
+        print(f"* superlinear: exponent above {args.max_exponent}")
+    return 1 if args.check and failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,296 @@
+#include <Emaject.hpp>
+
+#include <functional>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+#include "bench.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::Injector;
+    using emaject::bench::Runner;
+
+    struct Config
+    {
+        int value = 1;
+    };
+
+    class IService
+    {
+    public:
+        virtual ~IService() = default;
+        virtual int work() const = 0;
+    };
+
+    class Service : public IService
+    {
+    public:
+        int work() const override
+        {
+            return config ? config->value : 0;
+        }
+
+        [[INJECT(config)]]
+        std::shared_ptr<Config> config;
+    };
+
+    class Sized
+    {
+    public:
+        explicit Sized(int size) :
+            size(size)
+        {}
+        int size;
+    };
+
+    class FieldClient
+    {
+    public:
+        [[INJECT(service)]]
+        std::shared_ptr<IService> service;
+    };
+
+    class MethodClient
+    {
+    public:
+        [[INJECT(setService)]]
+        void setService(std::shared_ptr<IService> s)
+        {
+            service = std::move(s);
+        }
+        std::shared_ptr<IService> service;
+    };
+
+    class CtorClient
+    {
+    public:
+        INJECT_CTOR(CtorClient(std::shared_ptr<IService> s)) :
+            service(std::move(s))
+        {}
+        std::shared_ptr<IService> service;
+    };
+
+    class TraitsClient
+    {
+    public:
+        std::shared_ptr<IService> service;
+    };
+
+    template<size_t Index>
+    struct Registered
+    {
+        int value = static_cast<int>(Index);
+    };
+}
+
+namespace emaject
+{
+    template<>
+    struct InjectTraits<TraitsClient>
+    {
+        void onInject(TraitsClient* value, Container* c)
+        {
+            value->service = c->resolve<IService>();
+        }
+    };
+}
+
+namespace
+{
+    // the wiring every case would need without a container
+    std::shared_ptr<Service> make_service(const std::shared_ptr<Config>& config)
+    {
+        auto service = std::make_shared<Service>();
+        service->config = config;
+        return service;
+    }
+
+    Injector make_injector(const std::function<void(Container*)>& bindService)
+    {
+        Injector injector;
+        injector.install([&](Container* c) {
+            c->bind<Config>()
+                .asCached();
+            bindService(c);
+        });
+        injector.seal();
+        return injector;
+    }
+
+    void bench_resolve(Runner& runner)
+    {
+        const auto config = std::make_shared<Config>();
+        const std::shared_ptr<IService> shared = make_service(config);
+
+        {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asTransient();
+            });
+            runner.compare("resolve", "transient",
+                [&] { return injector.resolve<IService>(); },
+                [&] { return std::shared_ptr<IService>(make_service(config)); }
+            );
+        }
+        {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asCached();
+            });
+            runner.compare("resolve", "cached",
+                [&] { return injector.resolve<IService>(); },
+                [&] { return shared; }
+            );
+            runner.compare("resolve", "cached borrowed",
+                [&] { return injector.resolveBorrowed<IService>(); },
+                [&] { return shared.get(); }
+            );
+        }
+        {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asSingle();
+            });
+            runner.compare("resolve", "single",
+                [&] { return injector.resolve<IService>(); },
+                [&] { return shared; }
+            );
+        }
+        {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asPooled(4);
+            });
+            runner.compare("resolve", "pooled",
+                [&] { return injector.resolve<IService>(); },
+                [&] { return std::shared_ptr<IService>(make_service(config)); }
+            );
+        }
+        {
+            auto injector = make_injector([](Container* c) {
+                c->bind<IService>().to<Service>().asScoped();
+            });
+            auto scope = injector.beginScope();
+            runner.compare("resolve", "scoped",
+                [&] { return scope->resolve<IService>(); },
+                [&] { return shared; }
+            );
+            runner.compare("resolve", "scope cycle",
+                [&] {
+                    auto cycle = injector.beginScope();
+                    return cycle->resolve<IService>()->work();
+                },
+                [&] { return make_service(config)->work(); }
+            );
+        }
+    }
+
+    void bench_instantiate(Runner& runner)
+    {
+        const auto config = std::make_shared<Config>();
+        const std::shared_ptr<IService> shared = make_service(config);
+        auto injector = make_injector([](Container* c) {
+            c->bind<IService>().to<Service>().asCached();
+        });
+
+        runner.compare("instantiate", "field",
+            [&] { return injector.instantiate<FieldClient>(); },
+            [&] {
+                auto client = std::make_shared<FieldClient>();
+                client->service = shared;
+                return client;
+            }
+        );
+        runner.compare("instantiate", "method",
+            [&] { return injector.instantiate<MethodClient>(); },
+            [&] {
+                auto client = std::make_shared<MethodClient>();
+                client->setService(shared);
+                return client;
+            }
+        );
+        runner.compare("instantiate", "ctor",
+            [&] { return injector.instantiate<CtorClient>(); },
+            [&] { return std::make_shared<CtorClient>(shared); }
+        );
+        runner.compare("instantiate", "traits",
+            [&] { return injector.instantiate<TraitsClient>(); },
+            [&] {
+                auto client = std::make_shared<TraitsClient>();
+                client->service = shared;
+                return client;
+            }
+        );
+    }
+
+    void bench_chain(Runner& runner)
+    {
+        const auto config = std::make_shared<Config>();
+        auto injector = make_injector([&](Container* c) {
+            c->bind<Sized>()
+                .withArgs(64)
+                .asTransient();
+            c->bind<IService, 1>()
+                .to<Service>()
+                .fromFactory([config] {
+                    return make_service(config);
+                })
+                .asTransient();
+            c->bind<Service>()
+                .asTransient();
+            c->bind<IService, 2>()
+                .to<Service>()
+                .fromResolve()
+                .asTransient();
+        });
+
+        runner.compare("chain", "withArgs",
+            [&] { return injector.resolve<Sized>(); },
+            [&] { return std::make_shared<Sized>(64); }
+        );
+        runner.compare("chain", "fromFactory",
+            [&] { return injector.resolve<IService, 1>(); },
+            [&] { return std::shared_ptr<IService>(make_service(config)); }
+        );
+        runner.compare("chain", "fromResolve",
+            [&] { return injector.resolve<IService, 2>(); },
+            [&] { return std::shared_ptr<IService>(make_service(config)); }
+        );
+    }
+
+    template<size_t... Indices>
+    void bench_registration(Runner& runner, std::index_sequence<Indices...>)
+    {
+        constexpr size_t count = sizeof...(Indices);
+        char name[32];
+        std::snprintf(name, sizeof(name), "%zu bindings", count);
+
+        // a hand-written service locator is the closest thing to registration without a container
+        using Locator = std::unordered_map<std::type_index, std::function<std::shared_ptr<void>()>>;
+        runner.compare("registration", name,
+            [&] {
+                Injector injector;
+                injector.install([](Container* c) {
+                    (c->bind<Registered<Indices>>().asTransient(), ...);
+                });
+                return injector.seal();
+            },
+            [&] {
+                Locator locator;
+                (locator.emplace(typeid(Registered<Indices>), [] { return std::make_shared<Registered<Indices>>(); }), ...);
+                return locator.size();
+            }
+        );
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Runner runner(argc, argv);
+    bench_resolve(runner);
+    bench_instantiate(runner);
+    bench_chain(runner);
+    bench_registration(runner, std::make_index_sequence<1>{});
+    bench_registration(runner, std::make_index_sequence<16>{});
+    bench_registration(runner, std::make_index_sequence<128>{});
+    return runner.finish();
+}
@@ -2,133 +2,2244 @@
 
 #include <memory>
 #include <functional>
-#include <any>
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <bit>
+#include <deque>
+#include <latch>
+#include <utility>
 #include <vector>
-#include <typeindex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMAJECT_CTRL_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define EMAJECT_CTRL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// opt-in per-binding counters; compiled out entirely unless defined to 1
+#if EMAJECT_ENABLE_METRICS
+#include <chrono>
+#include <string_view>
+#endif
 
 namespace emaject
 {
     class Container;
 
+    template<class T>
+    class Lazy;
+
+    template<class T, int ID = 0>
+    class Provider;
+
     template<class Type>
     struct InjectTraits
     {
         //void onInject(Type* value, Container* c)
     };
 
-    namespace detail
+    enum class ScopeKind : std::uint8_t
     {
-        template<class Type>
-        struct AutoInjector;
+        Transient,
+        Cached,
+        Single,
+        Pooled,
+        Scoped
+    };
 
-        template<auto Method, int... IDs>
-        struct MethodInjector;
+#if EMAJECT_ENABLE_METRICS
+    /// <summary>
+    /// Snapshot of one binding's counters. see Container::metrics
+    /// </summary>
+    struct BindingMetrics
+    {
+        static constexpr size_t LatencyBuckets = 32;
+
+        std::string_view type;
+        std::string_view to;
+        int id = 0;
+        ScopeKind kind = ScopeKind::Transient;
+
+        std::uint64_t resolves = 0;
+        // resolves served by an existing Cached, Single or Scoped instance or a pooled one
+        std::uint64_t cacheHits = 0;
+        std::uint64_t factoryCalls = 0;
+        std::uint64_t transientConstructions = 0;
+        // factoryLatency[i] counts factory calls taking [2^i, 2^(i+1)) ns, including the dependencies they resolve
+        std::array<std::uint64_t, LatencyBuckets> factoryLatency{};
+    };
+#endif
+
+    /// <summary>
+    /// Allocator carving instances from a size-class pool shared by its copies
+    /// Instances keep the pool alive, so they may outlive the container.
+    /// </summary>
+    template<class T>
+    class PoolAllocator
+    {
+        template<class U>
+        friend class PoolAllocator;
+    public:
+        using value_type = T;
+
+        PoolAllocator() :
+            m_pool(std::make_shared<std::pmr::synchronized_pool_resource>())
+        {}
+        template<class U>
+        PoolAllocator(const PoolAllocator<U>& other) noexcept :
+            m_pool(other.m_pool)
+        {}
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            return static_cast<T*>(m_pool->allocate(n * sizeof(T), alignof(T)));
+        }
+        void deallocate(T* p, size_t n) noexcept
+        {
+            m_pool->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template<class U>
+        bool operator==(const PoolAllocator<U>& other) const noexcept
+        {
+            return m_pool == other.m_pool;
+        }
+    private:
+        std::shared_ptr<std::pmr::synchronized_pool_resource> m_pool;
+    };
+
+    namespace detail
+    {
+        /// <summary>
+        /// Compile-time type key (no RTTI required)
+        /// The key is the address of a per-type variable, which is only unique within one module:
+        /// a DLL, a shared object built with -fvisibility=hidden or one loaded with RTLD_LOCAL
+        /// gets its own copy, so a type bound there isn't found from the executable and vice versa.
+        /// Bind and resolve a type from the same module, or export the installer and the types
+        /// from a single shared library that every module links against.
+        /// </summary>
+        using TypeId = const void*;
 
         template<class Type>
-        concept TraitsInjectable = requires(Type * t, Container * c)
+        struct TypeIdHolder
         {
-            InjectTraits<Type>{}.onInject(t, c);
+            // non-const so that the linker can't fold identical constants
+            static inline char id = 0;
         };
 
         template<class Type>
-        concept AutoInjectable = requires(Type * t, Container * c)
+        inline constexpr TypeId TypeIdOf = &TypeIdHolder<Type>::id;
+
+        struct TypeIdHash
         {
-            AutoInjector<Type>{}.onInject(t, c);
+            size_t operator()(TypeId id) const noexcept
+            {
+                // Fibonacci hashing: type ids are addresses, so spread their low entropy bits
+                auto x = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(id));
+                x *= 0x9E3779B97F4A7C15ULL;
+                x ^= x >> 32;
+                return static_cast<size_t>(x);
+            }
         };
 
-        template<class Type, auto Method>
-        concept MethodInjectable = requires(Type * t, Container * c)
+        /// <summary>
+        /// Bit set of matching slots in a control group
+        /// </summary>
+        class CtrlMask
         {
-            requires std::is_member_function_pointer_v<decltype(Method)>;
-            typename MethodInjector<Method>::Type;
-            MethodInjector<Method>{}.onInject(t, c);
+        public:
+            constexpr CtrlMask(std::uint64_t bits, int shift) noexcept :
+                m_bits(bits),
+                m_shift(shift)
+            {}
+            explicit constexpr operator bool() const noexcept
+            {
+                return m_bits != 0;
+            }
+            constexpr size_t lowest() const noexcept
+            {
+                return static_cast<size_t>(std::countr_zero(m_bits) >> m_shift);
+            }
+            constexpr CtrlMask next() const noexcept
+            {
+                return { m_bits & (m_bits - 1), m_shift };
+            }
+        private:
+            std::uint64_t m_bits;
+            int m_shift;
+        };
+
+        /// <summary>
+        /// Control bytes of one probe group
+        /// empty = 0x80, full = low 7 bits of the hash
+        /// </summary>
+        class CtrlGroup
+        {
+        public:
+            static constexpr std::int8_t Empty = -128;
+#if EMAJECT_CTRL_SSE2
+            static constexpr size_t Width = 16;
+
+            explicit CtrlGroup(const std::int8_t* ctrl) noexcept :
+                m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+            {}
+            CtrlMask match(std::int8_t h2) const noexcept
+            {
+                return { static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))), 0 };
+            }
+            CtrlMask matchEmpty() const noexcept
+            {
+                return { static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl)), 0 };
+            }
+        private:
+            __m128i m_ctrl;
+#elif EMAJECT_CTRL_NEON
+            static constexpr size_t Width = 8;
+
+            explicit CtrlGroup(const std::int8_t* ctrl) noexcept :
+                m_ctrl(vld1_u8(reinterpret_cast<const std::uint8_t*>(ctrl)))
+            {}
+            CtrlMask match(std::int8_t h2) const noexcept
+            {
+                const uint8x8_t eq = vceq_u8(m_ctrl, vdup_n_u8(static_cast<std::uint8_t>(h2)));
+                return { vget_lane_u64(vreinterpret_u64_u8(eq), 0) & Msbs, 3 };
+            }
+            CtrlMask matchEmpty() const noexcept
+            {
+                return { vget_lane_u64(vreinterpret_u64_u8(m_ctrl), 0) & Msbs, 3 };
+            }
+        private:
+            static constexpr std::uint64_t Msbs = 0x8080808080808080ULL;
+            uint8x8_t m_ctrl;
+#else
+            static constexpr size_t Width = 8;
+
+            explicit CtrlGroup(const std::int8_t* ctrl) noexcept
+            {
+                std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl));
+            }
+            CtrlMask match(std::int8_t h2) const noexcept
+            {
+                // may report false positives; the caller compares keys anyway
+                const std::uint64_t x = m_ctrl ^ (Lsbs * static_cast<std::uint8_t>(h2));
+                return { ((x - Lsbs) & ~x & Msbs), 3 };
+            }
+            CtrlMask matchEmpty() const noexcept
+            {
+                return { m_ctrl & Msbs, 3 };
+            }
+        private:
+            static constexpr std::uint64_t Lsbs = 0x0101010101010101ULL;
+            static constexpr std::uint64_t Msbs = 0x8080808080808080ULL;
+            std::uint64_t m_ctrl;
+#endif
+        };
+
+        /// <summary>
+        /// Open-addressing hash map probed a control group at a time
+        /// Insert-only: bindings are never removed from a Container
+        /// </summary>
+        template<class Key, class Value, class Hash = TypeIdHash>
+        class FlatMap
+        {
+        public:
+            FlatMap() = default;
+            FlatMap(const FlatMap&) = delete;
+            FlatMap& operator=(const FlatMap&) = delete;
+            ~FlatMap()
+            {
+                clear();
+                release();
+            }
+
+            [[nodiscard]] Value* find(const Key& key) noexcept
+            {
+                return const_cast<Value*>(std::as_const(*this).find(key));
+            }
+            [[nodiscard]] const Value* find(const Key& key) const noexcept
+            {
+                if (m_size == 0) {
+                    return nullptr;
+                }
+                const size_t hash = m_hash(key);
+                const auto h2 = static_cast<std::int8_t>(hash & 0x7F);
+                const size_t groupMask = m_capacity / CtrlGroup::Width - 1;
+                size_t group = (hash >> 7) & groupMask;
+                for (size_t step = 1; ; ++step) {
+                    const size_t base = group * CtrlGroup::Width;
+                    const CtrlGroup ctrl(m_ctrl.get() + base);
+                    for (auto mask = ctrl.match(h2); mask; mask = mask.next()) {
+                        const Entry& entry = m_entries[base + mask.lowest()];
+                        if (entry.key == key) {
+                            return &entry.value;
+                        }
+                    }
+                    if (ctrl.matchEmpty()) {
+                        return nullptr;
+                    }
+                    group = (group + step) & groupMask;
+                }
+            }
+
+            template<class... Args>
+            std::pair<Value*, bool> tryEmplace(const Key& key, Args&&... args)
+            {
+                if (Value* found = find(key)) {
+                    return { found, false };
+                }
+                if (m_growthLeft == 0) {
+                    rehash(m_capacity == 0 ? CtrlGroup::Width : m_capacity * 2);
+                }
+                Entry* entry = insertUnique(m_hash(key));
+                std::construct_at(entry, key, std::forward<Args>(args)...);
+                ++m_size;
+                --m_growthLeft;
+                return { &entry->value, true };
+            }
+
+            template<class F>
+            void forEach(F&& f)
+            {
+                for (size_t i = 0; i < m_capacity; ++i) {
+                    if (m_ctrl[i] != CtrlGroup::Empty) {
+                        f(std::as_const(m_entries[i].key), m_entries[i].value);
+                    }
+                }
+            }
+
+            [[nodiscard]] size_t size() const noexcept
+            {
+                return m_size;
+            }
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return m_size == 0;
+            }
+
+            void clear() noexcept
+            {
+                for (size_t i = 0; i < m_capacity; ++i) {
+                    if (m_ctrl[i] != CtrlGroup::Empty) {
+                        std::destroy_at(&m_entries[i]);
+                        m_ctrl[i] = CtrlGroup::Empty;
+                    }
+                }
+                m_size = 0;
+                m_growthLeft = maxLoad(m_capacity);
+            }
+            void reset() noexcept
+            {
+                this->clear();
+                this->release();
+            }
+        private:
+            struct Entry
+            {
+                template<class... Args>
+                Entry(const Key& k, Args&&... args) :
+                    key(k),
+                    value(std::forward<Args>(args)...)
+                {}
+                Key key;
+                Value value;
+            };
+            static constexpr size_t maxLoad(size_t capacity) noexcept
+            {
+                return capacity - capacity / 8;
+            }
+
+            // assumes the key is absent and there is room
+            Entry* insertUnique(size_t hash) noexcept
+            {
+                const size_t groupMask = m_capacity / CtrlGroup::Width - 1;
+                size_t group = (hash >> 7) & groupMask;
+                for (size_t step = 1; ; ++step) {
+                    const size_t base = group * CtrlGroup::Width;
+                    if (auto empty = CtrlGroup(m_ctrl.get() + base).matchEmpty()) {
+                        const size_t index = base + empty.lowest();
+                        m_ctrl[index] = static_cast<std::int8_t>(hash & 0x7F);
+                        return &m_entries[index];
+                    }
+                    group = (group + step) & groupMask;
+                }
+            }
+            void rehash(size_t capacity)
+            {
+                auto oldCtrl = std::exchange(m_ctrl, std::make_unique<std::int8_t[]>(capacity));
+                Entry* oldEntries = std::exchange(m_entries, std::allocator<Entry>{}.allocate(capacity));
+                const size_t oldCapacity = std::exchange(m_capacity, capacity);
+                std::memset(m_ctrl.get(), CtrlGroup::Empty, capacity);
+
+                for (size_t i = 0; i < oldCapacity; ++i) {
+                    if (oldCtrl[i] != CtrlGroup::Empty) {
+                        Entry* entry = insertUnique(m_hash(oldEntries[i].key));
+                        std::construct_at(entry, std::move(oldEntries[i]));
+                        std::destroy_at(&oldEntries[i]);
+                    }
+                }
+                if (oldEntries) {
+                    std::allocator<Entry>{}.deallocate(oldEntries, oldCapacity);
+                }
+                m_growthLeft = maxLoad(m_capacity) - m_size;
+            }
+            void release() noexcept
+            {
+                if (m_entries) {
+                    std::allocator<Entry>{}.deallocate(m_entries, m_capacity);
+                }
+                m_entries = nullptr;
+                m_ctrl.reset();
+                m_capacity = 0;
+                m_growthLeft = 0;
+            }
+        private:
+            std::unique_ptr<std::int8_t[]> m_ctrl;
+            Entry* m_entries = nullptr;
+            size_t m_capacity = 0;
+            size_t m_size = 0;
+            size_t m_growthLeft = 0;
+            [[no_unique_address]] Hash m_hash;
+        };
+
+        /// <summary>
+        /// Immutable map with a collision-free index (hash and displace)
+        /// A lookup is one displacement read and one key compare, with no probing.
+        /// </summary>
+        template<class Value>
+        class PerfectHashMap
+        {
+        public:
+            void build(const std::vector<std::pair<TypeId, Value>>& items)
+            {
+                const size_t bucketCount = std::bit_ceil(std::max<size_t>(items.size() / 2, 1));
+                size_t capacity = std::bit_ceil(std::max<size_t>(items.size() + items.size() / 4, 2));
+                while (!this->tryBuild(items, bucketCount, capacity)) {
+                    capacity *= 2;
+                }
+            }
+
+            [[nodiscard]] const Value* find(TypeId key) const noexcept
+            {
+                if (m_entries.empty()) {
+                    return nullptr;
+                }
+                const std::uint64_t hash = mix(key);
+                const Entry& entry = m_entries[this->index(hash, m_displacements[hash & m_bucketMask])];
+                return entry.key == key ? &entry.value : nullptr;
+            }
+            [[nodiscard]] size_t size() const noexcept
+            {
+                return m_size;
+            }
+        private:
+            struct Entry
+            {
+                TypeId key = nullptr;
+                Value value{};
+            };
+            static constexpr std::uint32_t MaxDisplacement = 1 << 16;
+
+            static std::uint64_t mix(TypeId key) noexcept
+            {
+                auto x = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key));
+                x *= 0x9E3779B97F4A7C15ULL;
+                return x ^ (x >> 32);
+            }
+            size_t index(std::uint64_t hash, std::uint32_t displacement) const noexcept
+            {
+                return static_cast<size_t>(((hash ^ displacement) * 0xff51afd7ed558ccdULL) >> m_shift);
+            }
+            bool tryBuild(const std::vector<std::pair<TypeId, Value>>& items, size_t bucketCount, size_t capacity)
+            {
+                m_bucketMask = bucketCount - 1;
+                m_shift = 64 - std::countr_zero(capacity);
+
+                std::vector<std::vector<size_t>> buckets(bucketCount);
+                for (size_t i = 0; i < items.size(); ++i) {
+                    buckets[mix(items[i].first) & m_bucketMask].push_back(i);
+                }
+                // place the most crowded buckets first while the table is still empty
+                std::vector<size_t> order(bucketCount);
+                for (size_t b = 0; b < bucketCount; ++b) {
+                    order[b] = b;
+                }
+                std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                    return buckets[a].size() > buckets[b].size();
+                });
+
+                std::vector<bool> used(capacity);
+                std::vector<size_t> indices;
+                m_displacements.assign(bucketCount, 0);
+                for (size_t b : order) {
+                    const auto& bucket = buckets[b];
+                    if (bucket.empty()) {
+                        break;
+                    }
+                    bool placed = false;
+                    for (std::uint32_t displacement = 0; displacement < MaxDisplacement && !placed; ++displacement) {
+                        indices.clear();
+                        placed = true;
+                        for (size_t i : bucket) {
+                            const size_t idx = this->index(mix(items[i].first), displacement);
+                            if (used[idx] || std::find(indices.begin(), indices.end(), idx) != indices.end()) {
+                                placed = false;
+                                break;
+                            }
+                            indices.push_back(idx);
+                        }
+                        if (placed) {
+                            for (size_t idx : indices) {
+                                used[idx] = true;
+                            }
+                            m_displacements[b] = displacement;
+                        }
+                    }
+                    if (!placed) {
+                        return false;
+                    }
+                }
+                m_entries.assign(capacity, Entry{});
+                for (const auto& [key, value] : items) {
+                    const std::uint64_t hash = mix(key);
+                    m_entries[this->index(hash, m_displacements[hash & m_bucketMask])] = { key, value };
+                }
+                m_size = items.size();
+                return true;
+            }
+        private:
+            std::vector<std::uint32_t> m_displacements;
+            std::vector<Entry> m_entries;
+            std::uint64_t m_bucketMask = 0;
+            int m_shift = 64;
+            size_t m_size = 0;
+        };
+
+        /// <summary>
+        /// Per-object once initialization
+        /// Readers only do an acquire load once the value is published,
+        /// concurrent initializers wait on this flag alone.
+        /// </summary>
+        class OnceFlag
+        {
+        public:
+            [[nodiscard]] bool isReady() const noexcept
+            {
+                return m_state.load(std::memory_order_acquire) == Ready;
+            }
+
+            /// <summary>
+            /// Runs init unless already published and returns whether it is published.
+            /// init returns false to leave the flag unpublished so a later call retries.
+            /// </summary>
+            template<class Init>
+            bool call(Init&& init)
+            {
+                std::uint8_t state = m_state.load(std::memory_order_acquire);
+                while (state != Ready) {
+                    if (state == Building) {
+                        m_state.wait(Building, std::memory_order_acquire);
+                        state = m_state.load(std::memory_order_acquire);
+                        continue;
+                    }
+                    if (!m_state.compare_exchange_weak(state, Building, std::memory_order_acquire)) {
+                        continue;
+                    }
+                    bool published = false;
+                    try {
+                        published = init();
+                    } catch (...) {
+                        this->finish(Empty);
+                        throw;
+                    }
+                    this->finish(published ? Ready : Empty);
+                    return published;
+                }
+                return true;
+            }
+        private:
+            void finish(std::uint8_t state) noexcept
+            {
+                m_state.store(state, std::memory_order_release);
+                m_state.notify_all();
+            }
+        private:
+            static constexpr std::uint8_t Empty = 0;
+            static constexpr std::uint8_t Building = 1;
+            static constexpr std::uint8_t Ready = 2;
+
+            std::atomic<std::uint8_t> m_state = Empty;
         };
 
+#if EMAJECT_ENABLE_METRICS
+        /// <summary>
+        /// Readable name of Type taken from the compiler's function signature
+        /// </summary>
         template<class Type>
-        concept CtorInjectable = requires()
+        constexpr std::string_view type_name()
         {
-            typename Type::CtorInject;
+#if defined(_MSC_VER) && !defined(__clang__)
+            constexpr std::string_view signature = __FUNCSIG__;
+            constexpr size_t begin = signature.find("type_name<") + 10;
+            constexpr size_t end = signature.rfind(">(void)");
+#else
+            constexpr std::string_view signature = __PRETTY_FUNCTION__;
+            constexpr size_t begin = signature.find("Type = ") + 7;
+            // gcc appends "; std::string_view = ...]", clang only "]"
+            constexpr size_t end = signature.find(';', begin) != std::string_view::npos
+                ? signature.find(';', begin)
+                : signature.rfind(']');
+#endif
+            return signature.substr(begin, end - begin);
+        }
+
+        /// <summary>
+        /// Counters of one binding, updated with relaxed atomics
+        /// Aligned to keep the writes off the cache line resolves read.
+        /// </summary>
+        struct alignas(64) SlotMetrics
+        {
+            void onFactory(std::chrono::nanoseconds elapsed, bool transient) noexcept
+            {
+                factoryCalls.fetch_add(1, std::memory_order_relaxed);
+                if (transient) {
+                    transientConstructions.fetch_add(1, std::memory_order_relaxed);
+                }
+                const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed.count(), 1));
+                const size_t bucket = std::min<size_t>(std::bit_width(ns) - 1, BindingMetrics::LatencyBuckets - 1);
+                factoryLatency[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::string_view type;
+            std::string_view to;
+            int id = 0;
+
+            std::atomic<std::uint64_t> resolves = 0;
+            std::atomic<std::uint64_t> cacheHits = 0;
+            std::atomic<std::uint64_t> factoryCalls = 0;
+            std::atomic<std::uint64_t> transientConstructions = 0;
+            std::array<std::atomic<std::uint64_t>, BindingMetrics::LatencyBuckets> factoryLatency{};
         };
+#endif
 
-        template <class Type, class... Args>
-        concept DefaultInstantiatable = (sizeof...(Args) == 0 && detail::CtorInjectable<Type>) || std::constructible_from<Type, Args...>;
-    }
+        /// <summary>
+        /// Move-only callable with inline storage
+        /// Callables that don't fit the buffer are kept on the heap.
+        /// </summary>
+        template<class Signature, size_t Capacity = 48>
+        class InlineFunction;
+
+        template<class R, class... Args, size_t Capacity>
+        class InlineFunction<R(Args...), Capacity>
+        {
+            template<class Fn>
+            static constexpr bool FitsInline = sizeof(Fn) <= Capacity
+                && alignof(Fn) <= alignof(std::max_align_t)
+                && std::is_nothrow_move_constructible_v<Fn>;
+        public:
+            InlineFunction() = default;
+
+            template<class F>
+            requires (!std::same_as<std::decay_t<F>, InlineFunction>) && std::invocable<std::decay_t<F>&, Args...>
+            InlineFunction(F&& f)
+            {
+                using Fn = std::decay_t<F>;
+                if constexpr (FitsInline<Fn>) {
+                    std::construct_at(reinterpret_cast<Fn*>(m_storage), std::forward<F>(f));
+                } else {
+                    std::construct_at(reinterpret_cast<Fn**>(m_storage), new Fn(std::forward<F>(f)));
+                }
+                m_vtable = &VTableOf<Fn>;
+            }
+            InlineFunction(InlineFunction&& other) noexcept
+            {
+                this->moveFrom(other);
+            }
+            InlineFunction& operator=(InlineFunction&& other) noexcept
+            {
+                if (this != &other) {
+                    this->reset();
+                    this->moveFrom(other);
+                }
+                return *this;
+            }
+            ~InlineFunction()
+            {
+                this->reset();
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return m_vtable != nullptr;
+            }
+            R operator()(Args... args) const
+            {
+                return m_vtable->invoke(const_cast<std::byte*>(m_storage), std::forward<Args>(args)...);
+            }
+        private:
+            struct VTable
+            {
+                R(*invoke)(std::byte*, Args&&...);
+                void(*move)(std::byte* dst, std::byte* src) noexcept;
+                void(*destroy)(std::byte*) noexcept;
+            };
+            template<class Fn>
+            static Fn& target(std::byte* storage) noexcept
+            {
+                if constexpr (FitsInline<Fn>) {
+                    return *std::launder(reinterpret_cast<Fn*>(storage));
+                } else {
+                    return **std::launder(reinterpret_cast<Fn**>(storage));
+                }
+            }
+            template<class Fn>
+            static constexpr VTable VTableOf{
+                [](std::byte* storage, Args&&... args) -> R {
+                    return target<Fn>(storage)(std::forward<Args>(args)...);
+                },
+                [](std::byte* dst, std::byte* src) noexcept {
+                    if constexpr (FitsInline<Fn>) {
+                        std::construct_at(reinterpret_cast<Fn*>(dst), std::move(target<Fn>(src)));
+                        std::destroy_at(&target<Fn>(src));
+                    } else {
+                        std::construct_at(reinterpret_cast<Fn**>(dst), *std::launder(reinterpret_cast<Fn**>(src)));
+                    }
+                },
+                [](std::byte* storage) noexcept {
+                    if constexpr (FitsInline<Fn>) {
+                        std::destroy_at(&target<Fn>(storage));
+                    } else {
+                        delete &target<Fn>(storage);
+                    }
+                },
+            };
+
+            void moveFrom(InlineFunction& other) noexcept
+            {
+                if (other.m_vtable) {
+                    other.m_vtable->move(m_storage, other.m_storage);
+                    m_vtable = std::exchange(other.m_vtable, nullptr);
+                }
+            }
+            void reset() noexcept
+            {
+                if (m_vtable) {
+                    m_vtable->destroy(m_storage);
+                    m_vtable = nullptr;
+                }
+            }
+        private:
+            alignas(std::max_align_t) std::byte m_storage[Capacity];
+            const VTable* m_vtable = nullptr;
+        };
+
+        /// <summary>
+        /// Lock-free table of owned objects indexed by small dense ids
+        /// Chunks double in size and never move, so readers take no lock.
+        /// Only the chunk holding a used index is allocated, but that chunk has as many entries as
+        /// all lower chunks together: a table using index n costs about 8 * n bytes of pointers.
+        /// </summary>
+        template<class T>
+        class AtomicTable
+        {
+        public:
+            AtomicTable() = default;
+            AtomicTable(const AtomicTable&) = delete;
+            AtomicTable& operator=(const AtomicTable&) = delete;
+            ~AtomicTable()
+            {
+                for (size_t chunk = 0; chunk < ChunkCount; ++chunk) {
+                    std::atomic<T*>* entries = m_chunks[chunk].load(std::memory_order_relaxed);
+                    if (!entries) {
+                        continue;
+                    }
+                    for (size_t i = 0; i < (size_t{ 1 } << chunk); ++i) {
+                        delete entries[i].load(std::memory_order_relaxed);
+                    }
+                    delete[] entries;
+                }
+            }
+
+            [[nodiscard]] T* load(size_t index) const noexcept
+            {
+                const auto [chunk, offset] = locate(index);
+                const std::atomic<T*>* entries = m_chunks[chunk].load(std::memory_order_acquire);
+                return entries ? entries[offset].load(std::memory_order_acquire) : nullptr;
+            }
+
+            /// <summary>
+            /// Publish desired in place of expected.
+            /// On success the table owns desired and keeps expected alive until reclaim() or destruction,
+            /// since other threads may still read it.
+            /// </summary>
+            bool replace(size_t index, T* expected, std::unique_ptr<T>& desired)
+            {
+                T* const old = expected;
+                if (!this->entry(index).compare_exchange_strong(expected, desired.get(), std::memory_order_acq_rel)) {
+                    return false;
+                }
+                desired.release();
+                if (old) {
+                    std::lock_guard lock(m_retiredMutex);
+                    m_retired.emplace_back(old);
+                }
+                return true;
+            }
+
+            /// <summary>
+            /// Free the objects replaced so far
+            /// Only call it while no thread reads the table or still uses an object it loaded.
+            /// </summary>
+            void reclaim()
+            {
+                std::lock_guard lock(m_retiredMutex);
+                m_retired.clear();
+            }
+        private:
+            static constexpr size_t ChunkCount = sizeof(size_t) * 8;
+
+            static std::pair<size_t, size_t> locate(size_t index) noexcept
+            {
+                const size_t n = index + 1;
+                const size_t chunk = static_cast<size_t>(std::bit_width(n)) - 1;
+                return { chunk, n - (size_t{ 1 } << chunk) };
+            }
+            std::atomic<T*>& entry(size_t index)
+            {
+                const auto [chunk, offset] = locate(index);
+                std::atomic<T*>* entries = m_chunks[chunk].load(std::memory_order_acquire);
+                if (!entries) {
+                    auto* created = new std::atomic<T*>[size_t{ 1 } << chunk]();
+                    if (m_chunks[chunk].compare_exchange_strong(entries, created, std::memory_order_acq_rel)) {
+                        entries = created;
+                    } else {
+                        delete[] created;
+                    }
+                }
+                return entries[offset];
+            }
+        private:
+            std::array<std::atomic<std::atomic<T*>*>, ChunkCount> m_chunks{};
+            std::mutex m_retiredMutex;
+            std::vector<std::unique_ptr<T>> m_retired;
+        };
+
+        inline size_t next_dense_id()
+        {
+            static std::atomic<size_t> counter = 0;
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Process-wide dense id of Key, for indexing AtomicTable
+        /// </summary>
+        template<class Key>
+        size_t dense_id()
+        {
+            static const size_t id = next_dense_id();
+            return id;
+        }
+
+        /// <summary>
+        /// Free list of the shared_ptr control blocks of pooled handles
+        /// Every handle of a binding has the same control block type, so a freed block is reused as is.
+        /// The cache outlives its pool until the last block out comes back.
+        /// </summary>
+        class ControlBlockCache
+        {
+        public:
+            explicit ControlBlockCache(size_t capacity) :
+                m_capacity(capacity)
+            {}
+            ControlBlockCache(const ControlBlockCache&) = delete;
+            ControlBlockCache& operator=(const ControlBlockCache&) = delete;
+
+            /// <summary>
+            /// Give up the cache; it's deleted now or by the deallocation of the last block out
+            /// </summary>
+            void detach() noexcept
+            {
+                bool unused = false;
+                {
+                    std::lock_guard lock(m_mutex);
+                    m_detached = true;
+                    unused = m_outstanding == 0;
+                }
+                if (unused) {
+                    delete this;
+                }
+            }
+
+            [[nodiscard]] void* allocate(size_t size)
+            {
+                {
+                    std::lock_guard lock(m_mutex);
+                    if (m_free && size == m_size) {
+                        --m_count;
+                        ++m_outstanding;
+                        return std::exchange(m_free, m_free->next);
+                    }
+                }
+                void* block = ::operator new(size);
+                std::lock_guard lock(m_mutex);
+                ++m_outstanding;
+                return block;
+            }
+            void deallocate(void* block, size_t size) noexcept
+            {
+                bool unused = false;
+                {
+                    std::lock_guard lock(m_mutex);
+                    --m_outstanding;
+                    if (m_size == 0 && size >= sizeof(Node)) {
+                        m_size = size;
+                    }
+                    if (!m_detached && size == m_size && m_count < m_capacity) {
+                        m_free = ::new (block) Node{ m_free };
+                        ++m_count;
+                        return;
+                    }
+                    unused = m_detached && m_outstanding == 0;
+                }
+                ::operator delete(block);
+                if (unused) {
+                    delete this;
+                }
+            }
+        private:
+            ~ControlBlockCache()
+            {
+                while (m_free) {
+                    ::operator delete(std::exchange(m_free, m_free->next));
+                }
+            }
+        private:
+            struct Node
+            {
+                Node* next;
+            };
+            size_t m_capacity;
+            std::mutex m_mutex;
+            size_t m_size = 0;
+            size_t m_count = 0;
+            size_t m_outstanding = 0;
+            bool m_detached = false;
+            Node* m_free = nullptr;
+        };
+
+        /// <summary>
+        /// Allocator of pooled handles' control blocks
+        /// </summary>
+        template<class T>
+        struct ControlBlockAllocator
+        {
+            using value_type = T;
+
+            explicit ControlBlockAllocator(ControlBlockCache* cache) noexcept :
+                cache(cache)
+            {}
+            template<class U>
+            ControlBlockAllocator(const ControlBlockAllocator<U>& other) noexcept :
+                cache(other.cache)
+            {}
+
+            [[nodiscard]] T* allocate(size_t n)
+            {
+                static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+                return static_cast<T*>(cache->allocate(n * sizeof(T)));
+            }
+            void deallocate(T* p, size_t n) noexcept
+            {
+                cache->deallocate(p, n * sizeof(T));
+            }
+
+            template<class U>
+            bool operator==(const ControlBlockAllocator<U>& other) const noexcept
+            {
+                return cache == other.cache;
+            }
+
+            ControlBlockCache* cache;
+        };
+
+        /// <summary>
+        /// Idle instances of a Pooled binding waiting to be handed out again
+        /// </summary>
+        class InstancePool
+        {
+        public:
+            // returns true when the instance must be injected again before reuse
+            using Reset = InlineFunction<bool(void*)>;
+            using Inject = void(*)(Container*, void*);
+
+            explicit InstancePool(size_t capacity, Reset&& reset = {}, Inject inject = nullptr) :
+                m_capacity(capacity),
+                m_reset(std::move(reset)),
+                m_inject(inject),
+                m_blocks(new ControlBlockCache(capacity))
+            {}
+            InstancePool(const InstancePool&) = delete;
+            InstancePool& operator=(const InstancePool&) = delete;
+            ~InstancePool()
+            {
+                m_blocks->detach();
+            }
+
+            /// <summary>
+            /// Allocator recycling the control blocks of the handles
+            /// </summary>
+            [[nodiscard]] ControlBlockAllocator<std::byte> handleAllocator() const noexcept
+            {
+                return ControlBlockAllocator<std::byte>(m_blocks);
+            }
+
+            /// <summary>
+            /// Take an idle instance, or nullptr if none is left
+            /// </summary>
+            [[nodiscard]] std::shared_ptr<void> acquire(Container* c)
+            {
+                Idle idle;
+                {
+                    std::lock_guard lock(m_mutex);
+                    if (m_idle.empty()) {
+                        return nullptr;
+                    }
+                    idle = std::move(m_idle.back());
+                    m_idle.pop_back();
+                }
+                if (idle.reinject && m_inject) {
+                    m_inject(c, idle.instance.get());
+                }
+                return std::move(idle.instance);
+            }
+
+            /// <summary>
+            /// Reset and keep a released instance; it's destroyed if the pool is full
+            /// </summary>
+            void release(std::shared_ptr<void>&& instance)
+            {
+                const bool reinject = m_reset && m_reset(instance.get());
+                std::lock_guard lock(m_mutex);
+                if (m_idle.size() < m_capacity) {
+                    m_idle.push_back({ std::move(instance), reinject });
+                }
+            }
+        private:
+            struct Idle
+            {
+                std::shared_ptr<void> instance;
+                bool reinject = false;
+            };
+            size_t m_capacity;
+            Reset m_reset;
+            Inject m_inject;
+            std::mutex m_mutex;
+            std::vector<Idle> m_idle;
+            // handles outliving the pool keep only this alive, not the idle instances
+            ControlBlockCache* m_blocks;
+        };
+
+        /// <summary>
+        /// Deleter of a pooled handle; gives the instance back instead of destroying it
+        /// </summary>
+        struct PoolReturner
+        {
+            std::weak_ptr<InstancePool> pool;
+            std::shared_ptr<void> instance;
+
+            void operator()(void*)
+            {
+                if (auto p = pool.lock()) {
+                    p->release(std::move(instance));
+                }
+                instance.reset();
+            }
+        };
+
+        /// <summary>
+        /// Bump arena of a scope
+        /// Memory is only released all at once, when the arena is destroyed.
+        /// </summary>
+        class ScopeArena
+        {
+        public:
+            // the first instances of a scope are carved from here without touching the heap
+            static constexpr size_t InlineBytes = 2048;
+
+            ScopeArena() :
+                m_resource(m_inline, sizeof(m_inline))
+            {}
+
+            [[nodiscard]] void* allocate(size_t bytes, size_t alignment)
+            {
+                std::lock_guard lock(m_mutex);
+                void* p = m_resource.allocate(bytes, alignment);
+                m_live.fetch_add(1, std::memory_order_relaxed);
+                return p;
+            }
+            void deallocate() noexcept
+            {
+                // release: the owner's last use happens before the arena is rewound
+                m_live.fetch_sub(1, std::memory_order_release);
+            }
+
+            /// <summary>
+            /// Whether every allocation has been given back, so release() is safe
+            /// </summary>
+            [[nodiscard]] bool unused() const noexcept
+            {
+                return m_live.load(std::memory_order_acquire) == 0;
+            }
+
+            /// <summary>
+            /// Start over from the inline buffer; only valid once nothing allocated here is alive
+            /// </summary>
+            void release()
+            {
+                std::lock_guard lock(m_mutex);
+                m_resource.release();
+            }
+        private:
+            alignas(std::max_align_t) std::byte m_inline[InlineBytes];
+            std::mutex m_mutex;
+            std::pmr::monotonic_buffer_resource m_resource;
+            std::atomic<size_t> m_live = 0;
+        };
+
+        /// <summary>
+        /// Allocator over a ScopeArena
+        /// Every allocation holds the arena, so instances that escape the scope stay valid.
+        /// </summary>
+        template<class T>
+        class ArenaAllocator
+        {
+            template<class U>
+            friend class ArenaAllocator;
+        public:
+            using value_type = T;
+
+            explicit ArenaAllocator(std::shared_ptr<ScopeArena> arena) noexcept :
+                m_arena(std::move(arena))
+            {}
+            template<class U>
+            ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+                m_arena(other.m_arena)
+            {}
+
+            [[nodiscard]] T* allocate(size_t n)
+            {
+                return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+            }
+            void deallocate(T*, size_t) noexcept
+            {
+                m_arena->deallocate();
+            }
+
+            template<class U>
+            bool operator==(const ArenaAllocator<U>& other) const noexcept
+            {
+                return m_arena == other.m_arena;
+            }
+        private:
+            std::shared_ptr<ScopeArena> m_arena;
+        };
+
+        template<class Type>
+        struct AutoInjector;
+
+        template<auto Method, int... IDs>
+        struct MethodInjector;
+
+        template<class Type, class Resolver = Container>
+        concept TraitsInjectable = requires(Type * t, Resolver * c)
+        {
+            InjectTraits<Type>{}.onInject(t, c);
+        };
+
+        template<class Type>
+        concept AutoInjectable = requires(Type * t, Container * c)
+        {
+            AutoInjector<Type>{}.onInject(t, c);
+        };
+
+        template<class Type, auto Method>
+        concept MethodInjectable = requires(Type * t, Container * c)
+        {
+            requires std::is_member_function_pointer_v<decltype(Method)>;
+            typename MethodInjector<Method>::Type;
+            MethodInjector<Method>{}.onInject(t, c);
+        };
+
+        template<class Type>
+        concept CtorInjectable = requires()
+        {
+            typename Type::CtorInject;
+        };
+
+        template<class Factory, class Type>
+        concept FactoryInvocable = std::convertible_to<std::invoke_result_t<std::decay_t<Factory>&, Container*>, std::shared_ptr<Type>>
+            || std::convertible_to<std::invoke_result_t<std::decay_t<Factory>&>, std::shared_ptr<Type>>;
+
+        template <class Type, class... Args>
+        concept DefaultInstantiatable = (sizeof...(Args) == 0 && detail::CtorInjectable<Type>) || std::constructible_from<Type, Args...>;
+
+        template<class T>
+        struct IsLazy : std::false_type {};
+        template<class T>
+        struct IsLazy<Lazy<T>> : std::true_type {};
+
+        template<class T>
+        struct IsProvider : std::false_type {};
+        template<class T, int ID>
+        struct IsProvider<Provider<T, ID>> : std::true_type {};
+
+        /// <summary>
+        /// Resolver that outlives an injection; a resolver living only for one instantiate returns its container
+        /// </summary>
+        template<class Resolver>
+        auto* owner_of(Resolver* c)
+        {
+            if constexpr (requires { c->owner(); }) {
+                return c->owner();
+            } else {
+                return c;
+            }
+        }
+
+        /// <summary>
+        /// Value for an injected field or parameter of type Param
+        /// </summary>
+        template<class Param, int ID, class Resolver>
+        auto resolve_for(Resolver* c)
+        {
+            using Value = std::decay_t<Param>;
+            if constexpr (IsLazy<Value>::value) {
+                return Value::template from<ID>(detail::owner_of(c));
+            } else if constexpr (IsProvider<Value>::value) {
+                static_assert(ID == 0 || ID == Value::id, "Provider<T, ID> takes the ID from its type");
+                auto* owner = detail::owner_of(c);
+                if constexpr (requires { owner->template provider<typename Value::element_type, Value::id>(); }) {
+                    return owner->template provider<typename Value::element_type, Value::id>();
+                } else {
+                    return Value::from(owner);
+                }
+            } else {
+                return c->template resolve<typename Value::element_type, ID>();
+            }
+        }
+
+        /// <summary>
+        /// Record the binding an injected field or parameter of type Param needs up front
+        /// Lazy and Provider resolve on use, so they don't count.
+        /// </summary>
+        template<class Param, int ID, class Collector>
+        void depend_for(Collector* c)
+        {
+            using Value = std::decay_t<Param>;
+            if constexpr (!IsLazy<Value>::value && !IsProvider<Value>::value) {
+                c->template depend<typename Value::element_type, ID>();
+            }
+        }
+
+        template<class Type>
+        struct Instantiater
+        {
+            template<class T>
+            struct ctor {};
+            template<class T, class... Args>
+            struct ctor<T(Args...)>
+            {
+                template<class Alloc, class Resolver>
+                auto operator()(const Alloc& alloc, Resolver* c) const
+                {
+                    return std::allocate_shared<Type>(alloc, detail::resolve_for<Args, 0>(c)...);
+                }
+                template<class Collector>
+                void depend(Collector* c) const
+                {
+                    (detail::depend_for<Args, 0>(c), ...);
+                }
+            };
+
+            template<class Resolver, class... Args>
+            auto operator()(Resolver* c, Args&&... args) const
+            {
+                return this->allocate(std::allocator<Type>{}, c, std::forward<Args>(args)...);
+            }
+
+            template<class Alloc, class Resolver, class... Args>
+            auto allocate(const Alloc& alloc, Resolver* c, Args&&... args) const
+            {
+                if constexpr (sizeof...(Args) == 0 && detail::CtorInjectable<Type>) {
+                    return ctor<typename Type::CtorInject>{}(alloc, c);
+                } else if constexpr (std::constructible_from<Type, Args...>) {
+                    return std::allocate_shared<Type>(alloc, std::forward<Args>(args)...);
+                } else {
+                    return nullptr;
+                }
+            }
+        };
+    }
+
+    /// <summary>
+    /// Injection handle resolved on first use
+    /// Copies share the instance, which is resolved at most once even when used from several threads.
+    /// The injector it came from must outlive the first use. A handle from a scope resolves to nullptr once the scope ended,
+    /// since the scope is recycled for the next beginScope.
+    /// </summary>
+    template<class T>
+    class Lazy
+    {
+    public:
+        using element_type = T;
+
+        Lazy() = default;
+
+        template<int ID = 0, class Resolver>
+        [[nodiscard]] static Lazy from(Resolver* c)
+        {
+            Lazy ret;
+            ret.m_state = std::make_shared<State>();
+            ret.m_state->context = c;
+            if constexpr (std::is_same_v<Resolver, Container>) {
+                if (c->m_isScope) {
+                    ret.m_state->lease = c->m_self;
+                    ret.m_state->scoped = true;
+                }
+            }
+            ret.m_state->resolve = [](void* context) {
+                return static_cast<Resolver*>(context)->template resolve<T, ID>();
+            };
+            return ret;
+        }
+
+        [[nodiscard]] std::shared_ptr<T> value() const
+        {
+            if (!m_state) {
+                return nullptr;
+            }
+            m_state->once.call([state = m_state.get()] {
+                // keeps the scope from ending, and being reused, while resolving
+                std::shared_ptr<void> lease = state->lease.lock();
+                if (state->scoped && !lease) {
+                    return false;
+                }
+                state->instance = state->resolve(state->context);
+                return state->instance != nullptr;
+            });
+            return m_state->instance;
+        }
+        [[nodiscard]] T* get() const
+        {
+            return this->value().get();
+        }
+        [[nodiscard]] bool isResolved() const
+        {
+            return m_state && m_state->once.isReady();
+        }
+
+        T& operator*() const
+        {
+            return *this->get();
+        }
+        T* operator->() const
+        {
+            return this->get();
+        }
+        explicit operator bool() const
+        {
+            return this->get() != nullptr;
+        }
+        operator std::shared_ptr<T>() const
+        {
+            return this->value();
+        }
+    private:
+        struct State
+        {
+            detail::OnceFlag once;
+            std::shared_ptr<T> instance;
+            void* context = nullptr;
+            std::shared_ptr<T>(*resolve)(void*) = nullptr;
+            std::weak_ptr<void> lease;
+            bool scoped = false;
+        };
+        std::shared_ptr<State> m_state;
+    };
+
+    /// <summary>
+    /// Injectable factory point for a binding
+    /// A provider from a Container holds the binding itself, so get() skips the lookup.
+    /// The injector it came from must outlive it. A provider from a scope returns nullptr once the scope ended,
+    /// instead of resolving in the request that reuses it.
+    /// </summary>
+    template<class T, int ID>
+    class Provider
+    {
+    public:
+        using element_type = T;
+        static constexpr int id = ID;
+        using Func = std::shared_ptr<T>(*)(void* context, void* slot);
+
+        Provider() = default;
+        Provider(void* context, void* slot, Func func) :
+            m_context(context),
+            m_slot(slot),
+            m_func(func)
+        {}
+
+        template<class Resolver>
+        [[nodiscard]] static Provider from(Resolver* c)
+        {
+            return Provider(c, nullptr, [](void* context, void*) {
+                return static_cast<Resolver*>(context)->template resolve<T, ID>();
+            });
+        }
+
+        [[nodiscard]] std::shared_ptr<T> get() const
+        {
+            if (!m_func) {
+                return nullptr;
+            }
+            if (m_scoped) {
+                // keeps the scope from ending, and being reused, while resolving
+                const std::shared_ptr<void> lease = m_lease.lock();
+                return lease ? m_func(m_context, m_slot) : nullptr;
+            }
+            return m_func(m_context, m_slot);
+        }
+        [[nodiscard]] std::shared_ptr<T> operator()() const
+        {
+            return this->get();
+        }
+        explicit operator bool() const noexcept
+        {
+            return m_func != nullptr;
+        }
+    private:
+        friend class Container;
+
+        void* m_context = nullptr;
+        void* m_slot = nullptr;
+        Func m_func = nullptr;
+        // only for a scope: its handle, which expires when the scope ends
+        std::weak_ptr<void> m_lease;
+        bool m_scoped = false;
+    };
+
+    /// <summary>
+    /// Container
+    /// </summary>
+    class Container : public std::enable_shared_from_this<Container>
+    {
+        template<class T>
+        friend class Lazy;
+    public:
+        Container() = default;
+        ~Container()
+        {
+            delete m_scopeCache.load(std::memory_order_relaxed);
+        }
+
+        template<class Type, int ID = 0>
+        [[nodiscard]] auto bind()
+        {
+            return Binder<Type, ID>(this);
+        }
+
+        template<class Type, class...Args>
+        [[nodiscard]] std::shared_ptr<Type> instantiate(Args&&... args)
+        {
+            return this->instantiateWith<Type>(std::allocator<Type>{}, std::forward<Args>(args)...);
+        }
+        template<class Type, int ID = 0>
+        [[nodiscard]] std::shared_ptr<Type> resolve()
+        {
+            return this->resolveSlot<Type>(this->findSlot<Type, ID>());
+        }
+
+        /// <summary>
+        /// Resolve a Cached or Single instance without sharing ownership
+        /// The pointer stays valid as long as this container is alive.
+        /// Returns nullptr for Transient and Pooled bindings, which have no owner to borrow from.
+        /// A Scoped instance stays valid as long as its scope is alive.
+        /// </summary>
+        template<class Type, int ID = 0>
+        [[nodiscard]] Type* resolveBorrowed()
+        {
+            BindSlot* slot = this->findSlot<Type, ID>();
+            if (slot) {
+                this->onResolve(*slot);
+            }
+            if (slot && slot->kind == ScopeKind::Scoped) {
+                ScopedEntry* entry = this->scoped(*slot);
+                return entry ? static_cast<Type*>(entry->instance.get()) : nullptr;
+            }
+            if (!slot || slot->kind == ScopeKind::Transient || slot->kind == ScopeKind::Pooled || !this->publish(*slot)) {
+                return nullptr;
+            }
+            return static_cast<Type*>(slot->cache.get());
+        }
+
+        /// <summary>
+        /// Provider bound to the binding, or an empty one if nothing is bound
+        /// </summary>
+        template<class Type, int ID = 0>
+        [[nodiscard]] Provider<Type, ID> provider()
+        {
+            BindSlot* slot = this->findSlot<Type, ID>();
+            if (!slot) {
+                return {};
+            }
+            Provider<Type, ID> ret(this, slot, [](void* c, void* s) {
+                return static_cast<Container*>(c)->resolveSlot<Type>(static_cast<BindSlot*>(s));
+            });
+            if (m_isScope) {
+                ret.m_lease = m_self;
+                ret.m_scoped = true;
+            }
+            return ret;
+        }
+
+#if EMAJECT_ENABLE_METRICS
+        /// <summary>
+        /// Counters of the bindings registered in this container, not its parent's
+        /// Each counter is read on its own, so a snapshot taken while resolving isn't consistent across counters.
+        /// </summary>
+        [[nodiscard]] std::vector<BindingMetrics> metrics() const
+        {
+            std::vector<BindingMetrics> ret;
+            ret.reserve(m_slots.size());
+            for (const BindSlot& slot : m_slots) {
+                BindingMetrics& m = ret.emplace_back();
+                m.type = slot.metrics.type;
+                m.to = slot.metrics.to;
+                m.id = slot.metrics.id;
+                m.kind = slot.kind;
+                m.resolves = slot.metrics.resolves.load(std::memory_order_relaxed);
+                m.cacheHits = slot.metrics.cacheHits.load(std::memory_order_relaxed);
+                m.factoryCalls = slot.metrics.factoryCalls.load(std::memory_order_relaxed);
+                m.transientConstructions = slot.metrics.transientConstructions.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < BindingMetrics::LatencyBuckets; ++i) {
+                    m.factoryLatency[i] = slot.metrics.factoryLatency[i].load(std::memory_order_relaxed);
+                }
+            }
+            return ret;
+        }
+#endif
+
+        /// <summary>
+        /// Build every Cached and Single instance ahead of the first resolve
+        /// The edges between them are read from INJECT_CTOR, INJECT fields and INJECT methods, also through Transient
+        /// bindings in between. A binding is submitted to executor once all its inputs are published,
+        /// so independent subtrees run in parallel and no task waits for another.
+        /// Bindings whose inputs are only known at runtime (fromFactory, withArgs, InjectTraits), or that are on a cycle,
+        /// are submitted after all the others. executor is called from the tasks too, so it must accept any thread.
+        /// Returns false if a factory returned nullptr, and rethrows the first exception a factory or executor threw.
+        /// </summary>
+        template<class Executor>
+        bool warmup(Executor&& executor) requires std::invocable<Executor&, std::function<void()>>
+        {
+            std::deque<WarmupNode> nodes;
+            detail::FlatMap<const void*, size_t> targets;
+            for (BindSlot& slot : m_slots) {
+                if (slot.kind == ScopeKind::Cached || slot.kind == ScopeKind::Single) {
+                    targets.tryEmplace(&slot, nodes.size());
+                    nodes.emplace_back().slot = &slot;
+                }
+            }
+
+            std::vector<size_t> inputs;
+            std::vector<size_t> ready;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                inputs.clear();
+                if (!this->warmupInputs(*nodes[i].slot, targets, inputs)) {
+                    nodes[i].ordered = false;
+                    continue;
+                }
+                std::sort(inputs.begin(), inputs.end());
+                inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+                for (size_t input : inputs) {
+                    nodes[input].dependents.push_back(i);
+                }
+                nodes[i].pending.store(inputs.size(), std::memory_order_relaxed);
+            }
+
+            // topological order over the known nodes; what it can't reach depends on an unknown node or a cycle
+            std::vector<size_t> waiting(nodes.size());
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                waiting[i] = nodes[i].pending.load(std::memory_order_relaxed);
+                if (nodes[i].ordered && waiting[i] == 0) {
+                    ready.push_back(i);
+                }
+            }
+            size_t ordered = 0;
+            while (!ready.empty()) {
+                const size_t i = ready.back();
+                ready.pop_back();
+                ++ordered;
+                for (size_t dependent : nodes[i].dependents) {
+                    if (--waiting[dependent] == 0 && nodes[dependent].ordered) {
+                        ready.push_back(dependent);
+                    }
+                }
+            }
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                nodes[i].ordered = nodes[i].ordered && waiting[i] == 0;
+            }
+
+            return WarmupRun<std::remove_reference_t<Executor>>(this, executor, nodes, ordered).run();
+        }
+
+        /// <summary>
+        /// Build every Cached and Single instance on this thread
+        /// </summary>
+        bool warmup()
+        {
+            return this->warmup([](std::function<void()>&& task) {
+                task();
+            });
+        }
+
+        /// <summary>
+        /// Seal the bindings
+        /// Lookups switch to an immutable perfect hash table that any number of threads can read,
+        /// registration-only data is dropped and bind() fails from then on.
+        /// Returns false and stays unsealed if a fromResolve chain is dangling or cyclic.
+        /// Dependencies of INJECT, INJECT_CTOR and InjectTraits aren't checked: a child or scope may bind them later,
+        /// and an unbound one resolves to nullptr.
+        /// </summary>
+        bool freeze()
+        {
+            if (m_frozen) {
+                return true;
+            }
+            if (!this->validate()) {
+                return false;
+            }
+            std::vector<std::pair<detail::TypeId, BindSlot*>> slots;
+            slots.reserve(m_bindSlots.size());
+            m_bindSlots.forEach([&](detail::TypeId id, BindSlot* slot) {
+                slots.emplace_back(id, slot);
+            });
+            m_frozenSlots.build(slots);
+            m_bindSlots.reset();
+            m_derefInfos.reset();
+            m_frozen = true;
+            if (!m_scopePool) {
+                m_scopePool = std::make_shared<ScopePool>();
+            }
+            return true;
+        }
+        [[nodiscard]] bool isFrozen() const
+        {
+            return m_frozen;
+        }
+
+        /// <summary>
+        /// Create a child that registers its own bindings and falls back to this container on a miss
+        /// This container is sealed first and shared with the child, so nothing is copied.
+        /// Bindings found in the parent are built with the parent.
+        /// Returns nullptr if this container can't be sealed or isn't owned by a shared_ptr.
+        /// </summary>
+        [[nodiscard]] std::shared_ptr<Container> createChild()
+        {
+            std::shared_ptr<Container> self = this->shared();
+            if (!self || !this->freeze()) {
+                return nullptr;
+            }
+            auto child = std::make_shared<Container>();
+            child->m_parent = std::move(self);
+            return child;
+        }
+        [[nodiscard]] const std::shared_ptr<Container>& parent() const
+        {
+            return m_parent;
+        }
+
+        /// <summary>
+        /// Create a child that caches Scoped instances until it ends
+        /// Instances made with fromNew are carved from an arena of the scope, so its memory is released at once.
+        /// Ended scopes are cleared and reused by the next beginScope on this container.
+        /// Returns nullptr under the same conditions as createChild.
+        /// </summary>
+        [[nodiscard]] std::shared_ptr<Container> beginScope()
+        {
+            std::shared_ptr<Container> self = this->shared();
+            if (!self || !this->freeze()) {
+                return nullptr;
+            }
+            std::unique_ptr<Container> scope = m_scopePool->take();
+            if (!scope) {
+                scope = std::make_unique<Container>();
+                scope->m_isScope = true;
+                scope->scopeCache().arena = std::make_shared<detail::ScopeArena>();
+            }
+            scope->m_parent = std::move(self);
+
+            Container* raw = scope.get();
+            auto lease = std::allocate_shared<ScopeLease>(ScopeBlockAllocator<ScopeLease>(m_scopePool), std::move(scope), m_scopePool);
+            std::shared_ptr<Container> handle(std::move(lease), raw);
+            raw->m_self = handle;
+            return handle;
+        }
+        [[nodiscard]] bool isScope() const
+        {
+            return m_isScope;
+        }
+
+        template<class Type>
+        void inject(Type* value)
+        {
+            if constexpr (detail::AutoInjectable<Type>) {
+                if (value) {
+                    detail::AutoInjector<Type>{}.onInject(value, this);
+                }
+            }
+            if constexpr (detail::TraitsInjectable<Type>) {
+                if (value) {
+                    InjectTraits<Type>{}.onInject(value, this);
+                }
+            }
+        }
+    private:
+        template<class Type, int ID>
+        struct Tag {};
+
+        enum class FactoryKind : std::uint8_t
+        {
+            Instance,
+            New,
+            Resolve,
+            Callable,
+        };
+
+        /// <summary>
+        /// How a binding creates its instance
+        /// Instance needs no call, New and Resolve call a plain function,
+        /// only user factories go through a type-erased callable.
+        /// All of them return a pointer already converted to the bound type.
+        /// </summary>
+        struct SlotFactory
+        {
+            using Func = std::shared_ptr<void>(*)(Container*);
+            using ArenaFunc = std::shared_ptr<void>(*)(Container*, const detail::ArenaAllocator<std::byte>&);
+            using DependsFunc = bool(*)(std::vector<detail::TypeId>&);
+
+            template<class From, class To>
+            static SlotFactory makeNew()
+            {
+                SlotFactory ret;
+                ret.kind = FactoryKind::New;
+                ret.func = &createNew<From, To>;
+                ret.arenaFunc = &createNewIn<From, To>;
+                ret.depends = &Container::dependencies<To>;
+                return ret;
+            }
+            template<class From, class To, int ResolveID>
+            static SlotFactory makeResolve()
+            {
+                SlotFactory ret;
+                ret.kind = FactoryKind::Resolve;
+                ret.func = &createResolve<From, To, ResolveID>;
+                ret.resolveId = detail::TypeIdOf<Tag<To, ResolveID>>;
+                return ret;
+            }
+            template<class From>
+            static SlotFactory makeInstance(std::shared_ptr<From> instance)
+            {
+                SlotFactory ret;
+                ret.kind = FactoryKind::Instance;
+                ret.instance = std::move(instance);
+                return ret;
+            }
+            template<class From, class Factory>
+            static SlotFactory makeCallable(Factory&& factory)
+            {
+                SlotFactory ret;
+                ret.kind = FactoryKind::Callable;
+                if constexpr (std::invocable<std::decay_t<Factory>&, Container*>) {
+                    ret.callable = [f = std::forward<Factory>(factory)](Container* c) mutable -> std::shared_ptr<void> {
+                        return std::shared_ptr<From>(f(c));
+                    };
+                } else {
+                    ret.callable = [f = std::forward<Factory>(factory)](Container*) mutable -> std::shared_ptr<void> {
+                        return std::shared_ptr<From>(f());
+                    };
+                }
+                return ret;
+            }
+
+            /// <summary>
+            /// Bindings resolved while creating the instance; false if only the factory knows them
+            /// </summary>
+            bool dependencies(std::vector<detail::TypeId>& out) const
+            {
+                switch (kind) {
+                case FactoryKind::Instance:
+                    return true;
+                case FactoryKind::Resolve:
+                    out.push_back(resolveId);
+                    return true;
+                case FactoryKind::New:
+                    return depends(out);
+                default:
+                    return false;
+                }
+            }
+
+            std::shared_ptr<void> create(Container* c) const
+            {
+                switch (kind) {
+                case FactoryKind::Instance:
+                    return instance;
+                case FactoryKind::Callable:
+                    return callable(c);
+                default:
+                    return func(c);
+                }
+            }
+
+            FactoryKind kind = FactoryKind::Instance;
+            Func func = nullptr;
+            // only for New: builds the instance in a scope arena
+            ArenaFunc arenaFunc = nullptr;
+            // only for New: the bindings instantiate asks for
+            DependsFunc depends = nullptr;
+            detail::TypeId resolveId = nullptr;
+            std::shared_ptr<void> instance;
+            detail::InlineFunction<std::shared_ptr<void>(Container*)> callable;
+        private:
+            template<class From, class To>
+            static std::shared_ptr<void> createNew(Container* c)
+            {
+                return std::shared_ptr<From>(c->instantiate<To>());
+            }
+            template<class From, class To>
+            static std::shared_ptr<void> createNewIn(Container* c, const detail::ArenaAllocator<std::byte>& alloc)
+            {
+                return std::shared_ptr<From>(c->instantiateWith<To>(alloc));
+            }
+            template<class From, class To, int ResolveID>
+            static std::shared_ptr<void> createResolve(Container* c)
+            {
+                return std::shared_ptr<From>(c->resolve<To, ResolveID>());
+            }
+        };
+
+        /// <summary>
+        /// Type-erased binding record
+        /// cache holds a pointer already converted to the bound type, so resolve only casts it back
+        /// </summary>
+        struct BindSlot
+        {
+            // hot
+            detail::OnceFlag once;
+            ScopeKind kind;
+            std::shared_ptr<void> cache;
+            // container that registered the binding; Cached and Single instances are built with it
+            // so they never capture bindings of a child or scope. Other kinds are built with the resolving container.
+            Container* owner;
+
+            // cold
+            SlotFactory factory;
+            std::shared_ptr<detail::InstancePool> pool;
+#if EMAJECT_ENABLE_METRICS
+            detail::SlotMetrics metrics;
+#endif
+        };
+        template<class Type, bool CtorInject>
+        struct PlanTag {};
+
+        /// <summary>
+        /// Collects the binding ids an instantiation resolves
+        /// </summary>
+        struct DependencyCollector
+        {
+            template<class Type, int ID>
+            void depend()
+            {
+                ids->push_back(detail::TypeIdOf<Tag<Type, ID>>);
+            }
+            std::vector<detail::TypeId>* ids;
+        };
+
+        // bindings instantiate<Type>() resolves, read from INJECT_CTOR, INJECT fields and INJECT methods
+        // InjectTraits run arbitrary code, so a type using them reports false
+        template<class Type>
+        static bool dependencies(std::vector<detail::TypeId>& out)
+        {
+            if constexpr (detail::TraitsInjectable<Type>) {
+                return false;
+            } else {
+                DependencyCollector collector{ &out };
+                if constexpr (detail::CtorInjectable<Type>) {
+                    typename detail::Instantiater<Type>::template ctor<typename Type::CtorInject>{}.depend(&collector);
+                }
+                if constexpr (detail::AutoInjectable<Type>) {
+                    detail::AutoInjector<Type>{}.depend(&collector);
+                }
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// Binding of a warmup and the bindings waiting for it
+        /// </summary>
+        struct WarmupNode
+        {
+            BindSlot* slot = nullptr;
+            std::vector<size_t> dependents;
+            std::atomic<size_t> pending = 0;
+            // false if the inputs aren't known or are on a cycle; such bindings run after all others
+            bool ordered = true;
+        };
+
+        /// <summary>
+        /// One warmup in flight: a node is submitted when its last input is published
+        /// </summary>
+        template<class Executor>
+        class WarmupRun
+        {
+        public:
+            WarmupRun(Container* c, Executor& executor, std::deque<WarmupNode>& nodes, size_t ordered) :
+                m_container(c),
+                m_executor(executor),
+                m_nodes(nodes),
+                m_orderedLeft(ordered),
+                m_done(static_cast<std::ptrdiff_t>(nodes.size()))
+            {}
+
+            bool run()
+            {
+                if (m_orderedLeft.load(std::memory_order_relaxed) == 0) {
+                    this->submitUnordered();
+                } else {
+                    // collect the roots first: once submitted, nodes may finish and release others concurrently
+                    std::vector<size_t> roots;
+                    for (size_t i = 0; i < m_nodes.size(); ++i) {
+                        if (m_nodes[i].ordered && m_nodes[i].pending.load(std::memory_order_relaxed) == 0) {
+                            roots.push_back(i);
+                        }
+                    }
+                    for (size_t root : roots) {
+                        this->submit(root);
+                    }
+                }
+                m_done.wait();
+                if (m_error) {
+                    std::rethrow_exception(m_error);
+                }
+                return m_published.load(std::memory_order_relaxed);
+            }
+        private:
+            void submit(size_t index)
+            {
+                try {
+                    m_executor(std::function<void()>([this, index] {
+                        this->build(index);
+                    }));
+                } catch (...) {
+                    // the inputs are published, so building here can't wait on anything
+                    this->fail(std::current_exception());
+                    this->build(index);
+                }
+            }
+            void submitUnordered()
+            {
+                for (size_t i = 0; i < m_nodes.size(); ++i) {
+                    if (!m_nodes[i].ordered) {
+                        this->submit(i);
+                    }
+                }
+            }
+            void build(size_t index)
+            {
+                WarmupNode& node = m_nodes[index];
+                try {
+                    if (!m_container->publish(*node.slot)) {
+                        m_published.store(false, std::memory_order_relaxed);
+                    }
+                } catch (...) {
+                    this->fail(std::current_exception());
+                }
+                if (node.ordered) {
+                    for (size_t dependent : node.dependents) {
+                        WarmupNode& next = m_nodes[dependent];
+                        if (next.ordered && next.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                            this->submit(dependent);
+                        }
+                    }
+                    if (m_orderedLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        this->submitUnordered();
+                    }
+                }
+                // last: the warmup returns once every node counted down
+                m_done.count_down();
+            }
+            void fail(std::exception_ptr error)
+            {
+                std::lock_guard lock(m_errorMutex);
+                if (!m_error) {
+                    m_error = std::move(error);
+                }
+            }
+        private:
+            Container* m_container;
+            Executor& m_executor;
+            std::deque<WarmupNode>& m_nodes;
+            std::atomic<size_t> m_orderedLeft;
+            std::latch m_done;
+            std::atomic<bool> m_published = true;
+            std::mutex m_errorMutex;
+            std::exception_ptr m_error;
+        };
+
+        // Cached and Single bindings of this container that building slot resolves,
+        // looking through the bindings it builds on the spot; false if some of those are only known at runtime
+        bool warmupInputs(const BindSlot& slot, const detail::FlatMap<const void*, size_t>& targets, std::vector<size_t>& out) const
+        {
+            std::vector<const BindSlot*> stack{ &slot };
+            std::vector<const BindSlot*> visited;
+            std::vector<detail::TypeId> ids;
+            while (!stack.empty()) {
+                const BindSlot* current = stack.back();
+                stack.pop_back();
+                ids.clear();
+                if (!current->factory.dependencies(ids)) {
+                    return false;
+                }
+                for (detail::TypeId id : ids) {
+                    const BindSlot* input = this->findSlot(id);
+                    // missing bindings resolve to nullptr and the parent's are built by the parent
+                    if (!input || input->owner != this) {
+                        continue;
+                    }
+                    if (const size_t* target = targets.find(input)) {
+                        out.push_back(*target);
+                    } else if (std::find(visited.begin(), visited.end(), input) == visited.end()) {
+                        visited.push_back(input);
+                        stack.push_back(input);
+                    }
+                }
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Slots resolved by one instantiate<T>(), in the order the injectors ask for them
+        /// </summary>
+        struct InjectionPlan
+        {
+            size_t generation;
+            std::vector<std::pair<detail::TypeId, BindSlot*>> slots;
+        };
+
+        /// <summary>
+        /// Resolver for instantiate<T>()
+        /// Records the slots on the first instantiation and replays them afterwards without lookups.
+        /// </summary>
+        class PlanResolver
+        {
+        public:
+            PlanResolver(Container* c, const InjectionPlan* plan) :
+                m_container(c),
+                m_plan(plan)
+            {
+                if (!plan) {
+                    m_recording = std::make_unique<InjectionPlan>();
+                    m_recording->generation = c->m_generation;
+                }
+            }
+            template<class Type, int ID = 0>
+            [[nodiscard]] std::shared_ptr<Type> resolve()
+            {
+                return m_container->resolveSlot<Type>(this->next(detail::TypeIdOf<Tag<Type, ID>>));
+            }
+            [[nodiscard]] std::unique_ptr<InjectionPlan> recorded()
+            {
+                return std::move(m_recording);
+            }
+            [[nodiscard]] Container* owner() const
+            {
+                return m_container;
+            }
+        private:
+            BindSlot* next(detail::TypeId id)
+            {
+                if (m_recording) {
+                    BindSlot* slot = m_container->findSlot(id);
+                    m_recording->slots.emplace_back(id, slot);
+                    return slot;
+                }
+                if (m_cursor < m_plan->slots.size() && m_plan->slots[m_cursor].first == id) {
+                    return m_plan->slots[m_cursor++].second;
+                }
+                // the call sequence diverged from the plan
+                return m_container->findSlot(id);
+            }
+        private:
+            Container* m_container;
+            const InjectionPlan* m_plan;
+            size_t m_cursor = 0;
+            std::unique_ptr<InjectionPlan> m_recording;
+        };
 
-    /// <summary>
-    /// Container
-    /// </summary>
-    class Container
-    {
-    public:
-        template<class Type, int ID = 0>
-        [[nodiscard]] auto bind()
+        struct ScopedEntry
         {
-            return Binder<Type, ID>(this);
-        }
+            detail::OnceFlag once;
+            std::shared_ptr<void> instance;
+        };
 
-        template<class Type, class...Args>
-        [[nodiscard]] std::shared_ptr<Type> instantiate(Args&&... args)
+        /// <summary>
+        /// Scoped instances cached by a container, keyed by binding slot
+        /// </summary>
+        struct ScopeCache
         {
-            auto ret = this->makeInstance<Type>(std::forward<Args>(args)...);
-            this->inject(ret.get());
-            return ret;
-        }
-        template<class Type, int ID = 0>
-        [[nodiscard]] std::shared_ptr<Type> resolve()
+            std::mutex mutex;
+            std::deque<ScopedEntry> entries;
+            detail::FlatMap<detail::TypeId, ScopedEntry*> index;
+            // only for scopes; instances of the root are allocated normally
+            std::shared_ptr<detail::ScopeArena> arena;
+        };
+
+        /// <summary>
+        /// Ended scopes of a container, kept for the next beginScope
+        /// Also recycles the memory of the handles, so a scope cycle doesn't touch the heap once warm.
+        /// At most Capacity scopes and handle blocks are kept; what a burst opens beyond that is freed when it ends.
+        /// </summary>
+        struct ScopePool
         {
-            auto itr = m_bindInfos.find(typeid(Tag<Type, ID>));
-            if (itr == m_bindInfos.end()) {
-                return nullptr;
+            static constexpr size_t Capacity = 256;
+
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Container>> idle;
+            std::vector<void*> blocks;
+            size_t blockSize = 0;
+
+            ~ScopePool()
+            {
+                idle.clear();
+                for (void* block : blocks) {
+                    ::operator delete(block);
+                }
             }
-            auto&& [factory, createKind, cache] = std::any_cast<BindInfo<Type>&>(itr->second);
-            if (createKind != ScopeKind::Transient) {
-                if (!cache) {
-                    cache = factory(this);
+            std::unique_ptr<Container> take()
+            {
+                std::lock_guard lock(mutex);
+                if (idle.empty()) {
+                    return nullptr;
                 }
-                return std::static_pointer_cast<Type>(cache);
+                auto scope = std::move(idle.back());
+                idle.pop_back();
+                return scope;
             }
-            return std::static_pointer_cast<Type>(factory(this));
-        }
-
-        template<class Type>
-        void inject(Type* value)
-        {
-            if constexpr (detail::AutoInjectable<Type>) {
-                if (value) {
-                    detail::AutoInjector<Type>{}.onInject(value, this);
+            void recycle(std::unique_ptr<Container>&& scope)
+            {
+                scope->resetScope();
+                {
+                    std::lock_guard lock(mutex);
+                    if (idle.size() < Capacity) {
+                        idle.push_back(std::move(scope));
+                        return;
+                    }
                 }
+                // left over from a burst; destroyed outside the lock
+                scope.reset();
             }
-            if constexpr (detail::TraitsInjectable<Type>) {
-                if (value) {
-                    InjectTraits<Type>{}.onInject(value, this);
+            void* allocateBlock(size_t size)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    if (size == blockSize && !blocks.empty()) {
+                        void* block = blocks.back();
+                        blocks.pop_back();
+                        return block;
+                    }
+                    if (blockSize == 0) {
+                        blockSize = size;
+                    }
                 }
+                return ::operator new(size);
+            }
+            void deallocateBlock(void* block, size_t size) noexcept
+            {
+                try {
+                    std::lock_guard lock(mutex);
+                    if (size == blockSize && blocks.size() < Capacity) {
+                        blocks.push_back(block);
+                        return;
+                    }
+                } catch (...) {
+                }
+                ::operator delete(block);
             }
-        }
-    private:
-        enum class ScopeKind
-        {
-            Transient,
-            Cached,
-            Single
         };
-        template<class Type, int ID>
-        struct Tag {};
 
-        template<class Type>
-        using Factory = std::function<std::shared_ptr<Type>(Container*)>;
+        template<class T>
+        struct ScopeBlockAllocator
+        {
+            using value_type = T;
 
-        template<class Type>
-        struct BindInfo
+            explicit ScopeBlockAllocator(std::shared_ptr<ScopePool> p) noexcept :
+                pool(std::move(p))
+            {}
+            template<class U>
+            ScopeBlockAllocator(const ScopeBlockAllocator<U>& other) noexcept :
+                pool(other.pool)
+            {}
+
+            [[nodiscard]] T* allocate(size_t n)
+            {
+                static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+                return static_cast<T*>(pool->allocateBlock(n * sizeof(T)));
+            }
+            void deallocate(T* p, size_t n) noexcept
+            {
+                pool->deallocateBlock(p, n * sizeof(T));
+            }
+            template<class U>
+            bool operator==(const ScopeBlockAllocator<U>& other) const noexcept
+            {
+                return pool == other.pool;
+            }
+
+            std::shared_ptr<ScopePool> pool;
+        };
+
+        /// <summary>
+        /// Owner behind the handle of a scope; gives the scope back to the pool when the last handle is gone
+        /// </summary>
+        struct ScopeLease
         {
-            Factory<Type> factory;
-            ScopeKind kind;
-            std::shared_ptr<Type> cache;
+            ScopeLease(std::unique_ptr<Container>&& s, std::shared_ptr<ScopePool> p) :
+                scope(std::move(s)),
+                pool(std::move(p))
+            {}
+            ~ScopeLease()
+            {
+                pool->recycle(std::move(scope));
+            }
+            std::unique_ptr<Container> scope;
+            std::shared_ptr<ScopePool> pool;
         };
+
         struct DerefInfo
         {
             bool isSingle = false;
-            std::vector<std::type_index> bindIds;
+            std::vector<detail::TypeId> bindIds;
         };
         template<class Type, int ID>
         class Binder
@@ -161,18 +2272,24 @@ namespace emaject
             {
                 return toSelf().fromInstance(instance);
             }
-            [[nodiscard]] auto fromFactory(const Factory<Type>& factory) const
-            {
-                return toSelf().fromFactory(factory);
-            }
-            [[nodiscard]] auto fromFactory(const std::function<std::shared_ptr<Type>()>& factory) const
+            template<class Factory>
+            [[nodiscard]] auto fromFactory(Factory&& factory) const requires detail::FactoryInvocable<Factory, Type>
             {
-                return toSelf().fromFactory(factory);
+                return toSelf().fromFactory(std::forward<Factory>(factory));
             }
             [[nodiscard]] auto unused() const
             {
                 return toSelf().unused();
             }
+            template<class Alloc>
+            [[nodiscard]] auto withAllocator(const Alloc& alloc) const
+            {
+                return toSelf().withAllocator(alloc);
+            }
+            [[nodiscard]] auto withPool() const
+            {
+                return toSelf().withPool();
+            }
         public:
             bool asTransient() const requires detail::DefaultInstantiatable<Type>
             {
@@ -186,6 +2303,19 @@ namespace emaject
             {
                 return fromNew().asSingle();
             }
+            bool asScoped() const requires detail::DefaultInstantiatable<Type>
+            {
+                return fromNew().asScoped();
+            }
+            bool asPooled(size_t capacity) const requires detail::DefaultInstantiatable<Type>
+            {
+                return fromNew().asPooled(capacity);
+            }
+            template<class Reset>
+            bool asPooled(size_t capacity, Reset&& reset) const requires detail::DefaultInstantiatable<Type>
+            {
+                return fromNew().asPooled(capacity, std::forward<Reset>(reset));
+            }
         private:
             Container* m_container;
         };
@@ -200,9 +2330,7 @@ namespace emaject
         public:
             [[nodiscard]] auto fromNew() const requires detail::DefaultInstantiatable<To>
             {
-                return fromFactory([] (Container* c){
-                    return c->instantiate<To>();
-                });
+                return toScope(SlotFactory::makeNew<From, To>());
             }
             template<class... Args>
             [[nodiscard]] auto withArgs(Args&&... args) const requires std::constructible_from<To, Args...>
@@ -216,31 +2344,88 @@ namespace emaject
             }
             [[nodiscard]] auto fromInstance(const std::shared_ptr<To>& instance) const
             {
-                return fromFactory([i = instance] {
-                    return i;
-                });
-            }
-            [[nodiscard]] auto fromFactory(const Factory<To>& factory) const
-            {
-                return ScopeDescriptor<From, To, ID>(m_container, factory);
+                return toScope(SlotFactory::makeInstance<From>(instance));
             }
-            [[nodiscard]] auto fromFactory(const std::function<std::shared_ptr<To>()>& factory) const
+            template<class Factory>
+            [[nodiscard]] auto fromFactory(Factory&& factory) const requires detail::FactoryInvocable<Factory, To>
             {
-                return fromFactory([factory]([[maybe_unused]] Container* container) {
-                    return factory();
-                });
+                return toScope(SlotFactory::makeCallable<From>(std::forward<Factory>(factory)));
             }
             template<int RsolveID = 0>
             [[nodiscard]] auto fromResolve() const
             {
-                return fromFactory([](Container* c) {
-                    return c->resolve<To, RsolveID>();
-                });
+                return toScope(SlotFactory::makeResolve<From, To, RsolveID>());
             }
             [[nodiscard]] auto unused() const
             {
-                return fromFactory([]{
-                    return nullptr;
+                return toScope(SlotFactory::makeInstance<From>(nullptr));
+            }
+            template<class Alloc>
+            [[nodiscard]] auto withAllocator(const Alloc& alloc) const
+            {
+                return AllocatorDescriptor<From, To, ID, Alloc>(m_container, alloc);
+            }
+            [[nodiscard]] auto withPool() const
+            {
+                return this->withAllocator(PoolAllocator<To>{});
+            }
+        public:
+            bool asTransient() const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asTransient();
+            }
+            bool asCached() const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asCached();
+            }
+            bool asSingle() const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asSingle();
+            }
+            bool asScoped() const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asScoped();
+            }
+            bool asPooled(size_t capacity) const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asPooled(capacity);
+            }
+            template<class Reset>
+            bool asPooled(size_t capacity, Reset&& reset) const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asPooled(capacity, std::forward<Reset>(reset));
+            }
+        private:
+            auto toScope(SlotFactory&& factory) const
+            {
+                return ScopeDescriptor<From, To, ID>(m_container, std::move(factory));
+            }
+        private:
+            Container* m_container;
+        };
+        template<class From, class To, int ID, class Alloc>
+        class AllocatorDescriptor
+        {
+        public:
+            AllocatorDescriptor(Container* c, const Alloc& alloc) :
+                m_container(c),
+                m_alloc(alloc)
+            {}
+        public:
+            [[nodiscard]] auto fromNew() const requires detail::DefaultInstantiatable<To>
+            {
+                return toScope([alloc = m_alloc](Container* c) {
+                    return c->instantiateWith<To>(alloc);
+                });
+            }
+            template<class... Args>
+            [[nodiscard]] auto withArgs(Args&&... args) const requires std::constructible_from<To, Args...>
+            {
+                return toScope([alloc = m_alloc, ...args = std::forward<Args>(args)](Container* c) {
+                    // not allow move becouse transient
+                    auto ret = std::allocate_shared<To>(alloc, args...);
+                    c->inject(ret.get());
+                    return ret;
                 });
             }
         public:
@@ -256,95 +2441,411 @@ namespace emaject
             {
                 return fromNew().asSingle();
             }
+            bool asScoped() const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asScoped();
+            }
+            bool asPooled(size_t capacity) const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asPooled(capacity);
+            }
+            template<class Reset>
+            bool asPooled(size_t capacity, Reset&& reset) const requires detail::DefaultInstantiatable<To>
+            {
+                return fromNew().asPooled(capacity, std::forward<Reset>(reset));
+            }
+        private:
+            template<class Factory>
+            auto toScope(Factory&& factory) const
+            {
+                return ScopeDescriptor<From, To, ID>(m_container, SlotFactory::makeCallable<From>(std::forward<Factory>(factory)));
+            }
         private:
             Container* m_container;
+            Alloc m_alloc;
         };
+
         template<class From, class To, int ID>
         class ScopeDescriptor
         {
         public:
-            ScopeDescriptor(Container* c, const Factory<To>& f) :
+            ScopeDescriptor(Container* c, SlotFactory&& f) :
                 m_container(c),
-                m_factory(f)
+                m_factory(std::move(f))
             {}
         public:
             bool asTransient() const
             {
                 return m_container
-                    ->regist<From, To, ID>({ m_factory, ScopeKind::Transient, nullptr });
+                    ->regist<From, To, ID>(std::move(m_factory), ScopeKind::Transient);
             }
             bool asCached() const
             {
                 return m_container
-                    ->regist<From, To, ID>({ m_factory, ScopeKind::Cached, nullptr });
+                    ->regist<From, To, ID>(std::move(m_factory), ScopeKind::Cached);
             }
             bool asSingle() const
             {
                 return m_container
-                    ->regist<From, To, ID>({ m_factory, ScopeKind::Single, nullptr });
+                    ->regist<From, To, ID>(std::move(m_factory), ScopeKind::Single);
+            }
+            bool asScoped() const
+            {
+                return m_container
+                    ->regist<From, To, ID>(std::move(m_factory), ScopeKind::Scoped);
+            }
+            /// <summary>
+            /// Recycle released instances, keeping at most capacity idle ones
+            /// The control blocks of the returned handles are recycled too, so a warm pool doesn't allocate.
+            /// </summary>
+            bool asPooled(size_t capacity) const
+            {
+                return m_container
+                    ->regist<From, To, ID>(std::move(m_factory), ScopeKind::Pooled, std::make_shared<detail::InstancePool>(capacity));
+            }
+            /// <summary>
+            /// reset runs on each released instance; returning true re-injects it before reuse
+            /// </summary>
+            template<class Reset>
+            bool asPooled(size_t capacity, Reset&& reset) const requires std::invocable<Reset&, To&>
+            {
+                detail::InstancePool::Reset onReset = [r = std::forward<Reset>(reset)](void* instance) mutable {
+                    To& value = *static_cast<To*>(static_cast<From*>(instance));
+                    if constexpr (std::convertible_to<std::invoke_result_t<Reset&, To&>, bool>) {
+                        return static_cast<bool>(r(value));
+                    } else {
+                        r(value);
+                        return false;
+                    }
+                };
+                return m_container
+                    ->regist<From, To, ID>(
+                        std::move(m_factory),
+                        ScopeKind::Pooled,
+                        std::make_shared<detail::InstancePool>(capacity, std::move(onReset), &Container::reinject<From, To>)
+                    );
             }
         private:
             Container* m_container;
-            Factory<To> m_factory;
+            // moved out by the first as*() call; a second call fails as a duplicate binding anyway
+            mutable SlotFactory m_factory;
         };
 
+    private:
+        template<class Type>
+        [[nodiscard]] std::shared_ptr<Type> resolveSlot(BindSlot* slot)
+        {
+            if (!slot) {
+                return nullptr;
+            }
+            this->onResolve(*slot);
+            if (slot->kind == ScopeKind::Transient) {
+                return std::static_pointer_cast<Type>(this->build(*slot, [this, slot] {
+                    return slot->factory.create(this);
+                }));
+            }
+            if (slot->kind == ScopeKind::Pooled) {
+                return this->acquire<Type>(*slot);
+            }
+            if (slot->kind == ScopeKind::Scoped) {
+                ScopedEntry* entry = this->scoped(*slot);
+                return entry ? std::static_pointer_cast<Type>(entry->instance) : nullptr;
+            }
+            if (!this->publish(*slot)) {
+                return nullptr;
+            }
+            return std::static_pointer_cast<Type>(slot->cache);
+        }
+
         template<class Type>
-        struct Instantiater
+        [[nodiscard]] std::shared_ptr<Type> acquire(BindSlot& slot)
         {
-            template<class T>
-            struct ctor {};
-            template<class T, class... Args>
-            struct ctor<T(Args...)>
+            std::shared_ptr<void> instance = slot.pool->acquire(this);
+            if (instance) {
+                this->onCacheHit(slot);
+            } else {
+                instance = this->build(slot, [&] {
+                    return slot.factory.create(this);
+                });
+                if (!instance) {
+                    return nullptr;
+                }
+            }
+            Type* ptr = static_cast<Type*>(instance.get());
+            return std::shared_ptr<Type>(ptr, detail::PoolReturner{ slot.pool, std::move(instance) }, slot.pool->handleAllocator());
+        }
+
+        template<class From, class To>
+        static void reinject(Container* c, void* instance)
+        {
+            c->inject(static_cast<To*>(static_cast<From*>(instance)));
+        }
+
+        template<class Type, class Alloc, class...Args>
+        [[nodiscard]] std::shared_ptr<Type> instantiateWith(const Alloc& alloc, Args&&... args)
+        {
+            constexpr bool ctorInject = sizeof...(Args) == 0 && detail::CtorInjectable<Type>;
+            if constexpr (ctorInject || detail::AutoInjectable<Type>) {
+                return this->instantiateByPlan<Type, ctorInject>(alloc, std::forward<Args>(args)...);
+            } else {
+                std::shared_ptr<Type> ret = detail::Instantiater<Type>{}.allocate(alloc, this, std::forward<Args>(args)...);
+                this->inject(ret.get());
+                return ret;
+            }
+        }
+
+        template<class Type, bool CtorInject, class Alloc, class... Args>
+        [[nodiscard]] std::shared_ptr<Type> instantiateByPlan(const Alloc& alloc, Args&&... args)
+        {
+            const size_t planId = detail::dense_id<PlanTag<Type, CtorInject>>();
+            InjectionPlan* current = m_plans.load(planId);
+
+            PlanResolver resolver(this, current && current->generation == m_generation ? current : nullptr);
+            std::shared_ptr<Type> ret = detail::Instantiater<Type>{}.allocate(alloc, &resolver, std::forward<Args>(args)...);
+            if (ret) {
+                if constexpr (detail::AutoInjectable<Type>) {
+                    detail::AutoInjector<Type>{}.onInject(ret.get(), &resolver);
+                }
+                if constexpr (detail::TraitsInjectable<Type>) {
+                    InjectTraits<Type>{}.onInject(ret.get(), this);
+                }
+            }
+            if (auto recorded = resolver.recorded()) {
+                m_plans.replace(planId, current, recorded);
+            }
+            return ret;
+        }
+
+        template<class Type, int ID>
+        [[nodiscard]] BindSlot* findSlot() const
+        {
+            return this->findSlot(detail::TypeIdOf<Tag<Type, ID>>);
+        }
+        [[nodiscard]] BindSlot* findSlot(detail::TypeId id) const
+        {
+            BindSlot* const* found = m_frozen ? m_frozenSlots.find(id) : m_bindSlots.find(id);
+            if (found) {
+                return *found;
+            }
+            return m_parent ? m_parent->findSlot(id) : nullptr;
+        }
+
+        // fromResolve chains must end at a binding that isn't fromResolve
+        // a chain reaching the parent is fine from there on, since the parent is sealed
+        // only fromResolve is followed; what an instance injects may be bound by a child or scope created after this
+        bool validate() const
+        {
+            bool valid = true;
+            const size_t maxSteps = m_slots.size();
+            for (const BindSlot& slot : m_slots) {
+                const BindSlot* current = &slot;
+                for (size_t step = 0; valid && current->owner == this && current->factory.kind == FactoryKind::Resolve; ++step) {
+                    current = this->findSlot(current->factory.resolveId);
+                    valid = current != nullptr && step < maxSteps;
+                }
+            }
+            return valid;
+        }
+
+        // resolve counters; empty unless EMAJECT_ENABLE_METRICS
+        static void onResolve([[maybe_unused]] BindSlot& slot) noexcept
+        {
+#if EMAJECT_ENABLE_METRICS
+            slot.metrics.resolves.fetch_add(1, std::memory_order_relaxed);
+            if (slot.kind == ScopeKind::Cached || slot.kind == ScopeKind::Single) {
+                onCacheHit(slot, slot.once);
+            }
+#endif
+        }
+        static void onCacheHit([[maybe_unused]] BindSlot& slot) noexcept
+        {
+#if EMAJECT_ENABLE_METRICS
+            slot.metrics.cacheHits.fetch_add(1, std::memory_order_relaxed);
+#endif
+        }
+        static void onCacheHit([[maybe_unused]] BindSlot& slot, [[maybe_unused]] const detail::OnceFlag& once) noexcept
+        {
+#if EMAJECT_ENABLE_METRICS
+            if (once.isReady()) {
+                onCacheHit(slot);
+            }
+#endif
+        }
+
+        // every factory call of a binding goes through here so it can be timed
+        template<class Create>
+        static std::shared_ptr<void> build([[maybe_unused]] BindSlot& slot, Create&& create)
+        {
+#if EMAJECT_ENABLE_METRICS
+            const auto begin = std::chrono::steady_clock::now();
+            std::shared_ptr<void> instance = create();
+            slot.metrics.onFactory(std::chrono::steady_clock::now() - begin, slot.kind == ScopeKind::Transient);
+            return instance;
+#else
+            return create();
+#endif
+        }
+
+        bool publish(BindSlot& slot)
+        {
+            return slot.once.call([&] {
+                auto instance = this->build(slot, [&] {
+                    return slot.factory.create(slot.owner);
+                });
+                if (instance) {
+                    slot.cache = std::move(instance);
+                    return true;
+                }
+                return false;
+            });
+        }
+
+        /// <summary>
+        /// Instance of a Scoped binding, cached in the nearest scope between this container and the binding's owner
+        /// Without a scope the owner caches it like a Cached binding.
+        /// </summary>
+        ScopedEntry* scoped(BindSlot& slot)
+        {
+            Container* holder = this;
+            while (!holder->m_isScope && holder != slot.owner) {
+                holder = holder->m_parent.get();
+            }
+            ScopeCache& cache = holder->scopeCache();
+            ScopedEntry* entry;
             {
-                auto operator()(Container* c) const
-                {
-                    return std::make_shared<Type>(c->resolve<typename std::decay_t<Args>::element_type>()...);
+                std::lock_guard lock(cache.mutex);
+                auto [found, inserted] = cache.index.tryEmplace(&slot, nullptr);
+                if (inserted) {
+                    *found = &cache.entries.emplace_back();
                 }
-            };
+                entry = *found;
+            }
+            this->onCacheHit(slot, entry->once);
+            const bool published = entry->once.call([&] {
+                std::shared_ptr<void> instance = this->build(slot, [&] {
+                    return cache.arena && slot.factory.arenaFunc
+                        ? slot.factory.arenaFunc(holder, detail::ArenaAllocator<std::byte>(cache.arena))
+                        : slot.factory.create(holder);
+                });
+                if (!instance) {
+                    return false;
+                }
+                entry->instance = std::move(instance);
+                return true;
+            });
+            return published ? entry : nullptr;
+        }
+
+        // a pooled scope is owned through its lease, not enable_shared_from_this
+        std::shared_ptr<Container> shared()
+        {
+            if (auto self = m_self.lock()) {
+                return self;
+            }
+            return this->weak_from_this().lock();
+        }
+
+        // clear an ended scope for reuse, keeping the memory it has grown
+        void resetScope()
+        {
+            ScopeCache& cache = this->scopeCache();
+            cache.entries.clear();
+            cache.index.clear();
+            // counted per allocation: copies of the allocator may outlive the instances, and use_count is only a hint across threads
+            if (cache.arena->unused()) {
+                cache.arena->release();
+            } else {
+                // instances escaped the scope and still live in the arena
+                cache.arena = std::make_shared<detail::ScopeArena>();
+            }
+            if (m_frozen || !m_slots.empty()) {
+                m_slots.clear();
+                m_bindSlots.reset();
+                m_derefInfos.reset();
+                m_frozenSlots = {};
+                m_frozen = false;
+                this->nextGeneration();
+            }
+            m_self.reset();
+            m_parent.reset();
+        }
+
+        // registration and scope reuse never run alongside a resolve of this container,
+        // so plans replaced since the previous generation have no readers left
+        void nextGeneration()
+        {
+            ++m_generation;
+            m_plans.reclaim();
+        }
 
-            template<class... Args>
-            auto operator()(Container* c, Args&&... args) const
-            {
-                if constexpr (sizeof...(Args) == 0 && detail::CtorInjectable<Type>) {
-                    return ctor<typename Type::CtorInject>{}(c);
-                } else if constexpr (std::constructible_from<Type, Args...>) {
-                    return std::make_shared<Type>(std::forward<Args>(args)...);
-                } else {
-                    return nullptr;
+        ScopeCache& scopeCache()
+        {
+            ScopeCache* cache = m_scopeCache.load(std::memory_order_acquire);
+            if (!cache) {
+                auto created = std::make_unique<ScopeCache>();
+                if (m_scopeCache.compare_exchange_strong(cache, created.get(), std::memory_order_acq_rel)) {
+                    cache = created.release();
                 }
             }
-        };
-    private:
-        template<class Type, class...Args>
-        [[nodiscard]] std::shared_ptr<Type> makeInstance(Args&&... args)
-        {
-            return Instantiater<Type>{}(this, std::forward<Args>(args)...);
+            return *cache;
         }
 
         template<class From, class To, int ID>
-        bool regist(const BindInfo<From>& info)
+        bool regist(SlotFactory&& factory, ScopeKind kind, std::shared_ptr<detail::InstancePool> pool = nullptr)
         {
-            auto& deref = m_derefInfos[typeid(To)];
+            if (m_frozen) {
+                return false;
+            }
+            auto& deref = *m_derefInfos.tryEmplace(detail::TypeIdOf<To>).first;
             if (deref.isSingle) {
                 return false;
             }
-            const auto& id = typeid(Tag<From, ID>);
-            if (m_bindInfos.find(id) != m_bindInfos.end()) {
+            constexpr detail::TypeId id = detail::TypeIdOf<Tag<From, ID>>;
+            if (m_bindSlots.find(id)) {
                 return false;
             }
-            if (info.kind == ScopeKind::Single) {
+            if (kind == ScopeKind::Single) {
                 if (!deref.bindIds.empty()) {
                     return false;
                 }
                 deref.isSingle = true;
             }
-            m_bindInfos[id] = info;
+            this->nextGeneration();
+            BindSlot& slot = m_slots.emplace_back();
+            slot.kind = kind;
+            slot.owner = this;
+            slot.factory = std::move(factory);
+            slot.pool = std::move(pool);
+#if EMAJECT_ENABLE_METRICS
+            slot.metrics.type = detail::type_name<From>();
+            slot.metrics.to = detail::type_name<To>();
+            slot.metrics.id = ID;
+#endif
+            m_bindSlots.tryEmplace(id, &slot);
             deref.bindIds.push_back(id);
             return true;
         }
     private:
-        std::unordered_map<std::type_index, std::any> m_bindInfos;
-        std::unordered_map<std::type_index, DerefInfo> m_derefInfos;
+        // slots live in chunked storage so table entries stay small and slot addresses stay stable
+        std::deque<BindSlot> m_slots;
+        detail::FlatMap<detail::TypeId, BindSlot*> m_bindSlots;
+        detail::FlatMap<detail::TypeId, DerefInfo> m_derefInfos;
+
+        bool m_frozen = false;
+        detail::PerfectHashMap<BindSlot*> m_frozenSlots;
+
+        std::shared_ptr<Container> m_parent;
+        bool m_isScope = false;
+        std::atomic<ScopeCache*> m_scopeCache = nullptr;
+        // created when sealed, then only read
+        std::shared_ptr<ScopePool> m_scopePool;
+        std::weak_ptr<Container> m_self;
+
+        // bumped by every registration so plans recorded before it get rebuilt
+        size_t m_generation = 0;
+        // indexed by process-wide plan ids, so every container and scope that instantiates
+        // pays for entries up to the highest id it uses, whether or not the others are its own
+        detail::AtomicTable<InjectionPlan> m_plans;
     };
 
     /// <summary>
@@ -389,77 +2890,530 @@ namespace emaject
         {
             return m_container->resolve<Type, ID>();
         }
+        template<class Type, int ID = 0>
+        [[nodiscard]] Type* resolveBorrowed()
+        {
+            return m_container->resolveBorrowed<Type, ID>();
+        }
+        template<class Type, int ID = 0>
+        [[nodiscard]] Provider<Type, ID> provider()
+        {
+            return m_container->provider<Type, ID>();
+        }
+
+#if EMAJECT_ENABLE_METRICS
+        /// <summary>
+        /// Snapshot of the binding counters. see Container::metrics
+        /// </summary>
+        [[nodiscard]] std::vector<BindingMetrics> metrics() const
+        {
+            return m_container->metrics();
+        }
+#endif
+
+        /// <summary>
+        /// Seal the container after installing. see Container::freeze
+        /// </summary>
+        bool seal()
+        {
+            return m_container->freeze();
+        }
+
+        /// <summary>
+        /// Build Cached and Single instances up front. see Container::warmup
+        /// </summary>
+        template<class Executor>
+        bool warmup(Executor&& executor)
+        {
+            return m_container->warmup(std::forward<Executor>(executor));
+        }
+        bool warmup()
+        {
+            return m_container->warmup();
+        }
+
+        /// <summary>
+        /// Injector over a child container. see Container::createChild
+        /// </summary>
+        [[nodiscard]] std::optional<Injector> createChild()
+        {
+            auto child = m_container->createChild();
+            if (!child) {
+                return std::nullopt;
+            }
+            return Injector(std::move(child));
+        }
+
+        /// <summary>
+        /// Injector over a new scope. see Container::beginScope
+        /// </summary>
+        [[nodiscard]] std::optional<Injector> beginScope()
+        {
+            auto scope = m_container->beginScope();
+            if (!scope) {
+                return std::nullopt;
+            }
+            return Injector(std::move(scope));
+        }
+    private:
+        explicit Injector(std::shared_ptr<Container>&& container) :
+            m_container(std::move(container))
+        {}
+    private:
+        std::shared_ptr<Container> m_container;
+    };
+
+
+    /// <summary>
+    /// Binding for StaticInjector
+    /// Instances are created like fromNew().
+    /// </summary>
+    template<class From, class To = From, ScopeKind Kind = ScopeKind::Transient, int ID = 0>
+    struct Bind
+    {
+        static_assert(std::convertible_to<std::shared_ptr<To>, std::shared_ptr<From>>, "To must be convertible to From");
+        static_assert(detail::DefaultInstantiatable<To>, "To must be default constructible or have INJECT_CTOR");
+        static_assert(Kind != ScopeKind::Pooled && Kind != ScopeKind::Scoped, "Pooled and Scoped bindings need a Container");
+
+        using FromType = From;
+        using ToType = To;
+        static constexpr ScopeKind kind = Kind;
+        static constexpr int id = ID;
+    };
+
+    namespace detail
+    {
+        template<class Type, int ID, class... Bindings>
+        consteval size_t static_bind_index()
+        {
+            constexpr bool matches[] = { (std::same_as<typename Bindings::FromType, Type> && Bindings::id == ID)..., false };
+            for (size_t i = 0; i < sizeof...(Bindings); ++i) {
+                if (matches[i]) {
+                    return i;
+                }
+            }
+            return sizeof...(Bindings);
+        }
+        template<class... Bindings>
+        consteval bool static_bind_unique()
+        {
+            constexpr size_t indices[] = { static_bind_index<typename Bindings::FromType, Bindings::id, Bindings...>()..., 0 };
+            for (size_t i = 0; i < sizeof...(Bindings); ++i) {
+                if (indices[i] != i) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        template<class To, class... Bindings>
+        consteval size_t static_bind_count_to()
+        {
+            return (static_cast<size_t>(std::same_as<typename Bindings::ToType, To>) + ... + 0);
+        }
+        template<class... Bindings>
+        consteval bool static_bind_single()
+        {
+            // same rule as Container: a Single target can't be bound twice
+            return ((Bindings::kind != ScopeKind::Single || static_bind_count_to<typename Bindings::ToType, Bindings...>() == 1) && ...);
+        }
+
+        template<class Binding, bool Cache = Binding::kind != ScopeKind::Transient>
+        struct StaticSlot
+        {};
+
+        template<class Binding>
+        struct StaticSlot<Binding, true>
+        {
+            OnceFlag once;
+            std::shared_ptr<typename Binding::ToType> instance;
+        };
+
+        /// <summary>
+        /// Typed storage for compile-time bindings
+        /// The resolver passed in creates instances, so their dependencies resolve through it.
+        /// </summary>
+        template<class... Bindings>
+        class StaticSlots
+        {
+            static_assert(static_bind_unique<Bindings...>(), "same type and ID are bound twice");
+            static_assert(static_bind_single<Bindings...>(), "asSingle target is bound twice");
+        public:
+            static constexpr size_t npos = sizeof...(Bindings);
+
+            template<class Type, int ID>
+            static constexpr size_t indexOf = static_bind_index<Type, ID, Bindings...>();
+
+            template<size_t Index>
+            using BindingAt = std::tuple_element_t<Index, std::tuple<Bindings...>>;
+
+            template<size_t Index, class Resolver>
+            std::shared_ptr<typename BindingAt<Index>::FromType> resolve(Resolver* c)
+            {
+                using Binding = BindingAt<Index>;
+                if constexpr (Binding::kind == ScopeKind::Transient) {
+                    return c->template instantiate<typename Binding::ToType>();
+                } else {
+                    return this->publish<Index>(c).instance;
+                }
+            }
+            template<size_t Index, class Resolver>
+            typename BindingAt<Index>::FromType* resolveBorrowed(Resolver* c)
+            {
+                static_assert(BindingAt<Index>::kind != ScopeKind::Transient, "Transient bindings can't be borrowed");
+                return this->publish<Index>(c).instance.get();
+            }
+
+            /// <summary>
+            /// Register every binding in container with its own ScopeKind
+            /// Cached and Single bindings hand out the instance of their static slot, created through resolver.
+            /// </summary>
+            template<class Resolver>
+            void forwardTo(Container* container, Resolver* resolver)
+            {
+                this->forwardTo(container, resolver, std::make_index_sequence<npos>());
+            }
+        private:
+            template<class Resolver, size_t... Indices>
+            void forwardTo(Container* container, Resolver* resolver, std::index_sequence<Indices...>)
+            {
+                (this->forward<Indices>(container, resolver), ...);
+            }
+            template<size_t Index, class Resolver>
+            void forward(Container* container, Resolver* resolver)
+            {
+                using Binding = BindingAt<Index>;
+                using To = typename Binding::ToType;
+                auto bound = container->bind<typename Binding::FromType, Binding::id>()
+                    .template to<To>()
+                    .fromFactory([this, resolver]() -> std::shared_ptr<To> {
+                        if constexpr (Binding::kind == ScopeKind::Transient) {
+                            return resolver->template instantiate<To>();
+                        } else {
+                            return this->publish<Index>(resolver).instance;
+                        }
+                    });
+                if constexpr (Binding::kind == ScopeKind::Transient) {
+                    (void)bound.asTransient();
+                } else if constexpr (Binding::kind == ScopeKind::Cached) {
+                    (void)bound.asCached();
+                } else {
+                    (void)bound.asSingle();
+                }
+            }
+            template<size_t Index, class Resolver>
+            auto& publish(Resolver* c)
+            {
+                auto& slot = std::get<Index>(m_slots);
+                slot.once.call([&] {
+                    slot.instance = c->template instantiate<typename BindingAt<Index>::ToType>();
+                    return slot.instance != nullptr;
+                });
+                return slot;
+            }
+        private:
+            std::tuple<StaticSlot<Bindings>...> m_slots;
+        };
+    }
+
+    /// <summary>
+    /// Injector whose bindings are fixed at compile time
+    /// resolve compiles down to a direct construction or a read of a typed slot.
+    /// </summary>
+    template<class... Bindings>
+    class StaticInjector
+    {
+        using Slots = detail::StaticSlots<Bindings...>;
+    public:
+        StaticInjector() = default;
+        // the Container for InjectTraits captures this
+        StaticInjector(const StaticInjector&) = delete;
+        StaticInjector& operator=(const StaticInjector&) = delete;
+
+        template<class Type, class... Args>
+        [[nodiscard]] std::shared_ptr<Type> instantiate(Args&&... args) requires detail::DefaultInstantiatable<Type, Args...>
+        {
+            auto ret = detail::Instantiater<Type>{}(this, std::forward<Args>(args)...);
+            this->inject(ret.get());
+            return ret;
+        }
+
+        template<class Type, int ID = 0>
+        [[nodiscard]] std::shared_ptr<Type> resolve()
+        {
+            constexpr size_t index = Slots::template indexOf<Type, ID>;
+            if constexpr (index == Slots::npos) {
+                return nullptr;
+            } else {
+                return m_slots.template resolve<index>(this);
+            }
+        }
+
+        /// <summary>
+        /// Resolve a Cached or Single instance without sharing ownership
+        /// Borrowing a Transient binding is a compile error.
+        /// </summary>
+        template<class Type, int ID = 0>
+        [[nodiscard]] Type* resolveBorrowed()
+        {
+            constexpr size_t index = Slots::template indexOf<Type, ID>;
+            if constexpr (index == Slots::npos) {
+                return nullptr;
+            } else {
+                return m_slots.template resolveBorrowed<index>(this);
+            }
+        }
+
+        template<class Type>
+        void inject(Type* value)
+        {
+            if constexpr (detail::AutoInjectable<Type>) {
+                if (value) {
+                    detail::AutoInjector<Type>{}.onInject(value, this);
+                }
+            }
+            if constexpr (detail::TraitsInjectable<Type, StaticInjector>) {
+                if (value) {
+                    InjectTraits<Type>{}.onInject(value, this);
+                }
+            } else if constexpr (detail::TraitsInjectable<Type>) {
+                if (value) {
+                    InjectTraits<Type>{}.onInject(value, this->container());
+                }
+            }
+        }
     private:
+        /// <summary>
+        /// Container over the same bindings, for InjectTraits that only accept Container*
+        /// Created on first use, so injectors without such traits never allocate it.
+        /// </summary>
+        Container* container()
+        {
+            m_containerOnce.call([this] {
+                m_container = std::make_shared<Container>();
+                m_slots.forwardTo(m_container.get(), this);
+                return true;
+            });
+            return m_container.get();
+        }
+    private:
+        Slots m_slots;
+        detail::OnceFlag m_containerOnce;
         std::shared_ptr<Container> m_container;
     };
 
+    /// <summary>
+    /// Injector with compile-time hot bindings next to a runtime Container
+    /// Statically bound types resolve through a typed slot, everything else through the Container.
+    /// Static bindings are also registered in the Container with their ScopeKind, so runtime factories can resolve and borrow them too.
+    /// </summary>
+    template<class... Bindings>
+    class HybridInjector
+    {
+        using Slots = detail::StaticSlots<Bindings...>;
+    public:
+        HybridInjector() :
+            m_container(std::make_shared<Container>())
+        {
+            m_slots.forwardTo(m_container.get(), this);
+        }
+        // runtime bindings capture this
+        HybridInjector(const HybridInjector&) = delete;
+        HybridInjector& operator=(const HybridInjector&) = delete;
+
+        template<class Installer, class...Args>
+        HybridInjector& install(Args&&... args) requires std::is_base_of_v<IInstaller, Installer>
+        {
+            Installer(std::forward<Args>(args)...).onBinding(m_container.get());
+            return *this;
+        }
+
+        HybridInjector& install(const std::function<void(Container* c)>& installer)
+        {
+            installer(m_container.get());
+            return *this;
+        }
+
+        template<class Type, class... Args>
+        [[nodiscard]] std::shared_ptr<Type> instantiate(Args&&... args) requires detail::DefaultInstantiatable<Type, Args...>
+        {
+            auto ret = detail::Instantiater<Type>{}(this, std::forward<Args>(args)...);
+            this->inject(ret.get());
+            return ret;
+        }
+
+        template<class Type, int ID = 0>
+        [[nodiscard]] std::shared_ptr<Type> resolve()
+        {
+            constexpr size_t index = Slots::template indexOf<Type, ID>;
+            if constexpr (index == Slots::npos) {
+                return m_container->resolve<Type, ID>();
+            } else {
+                return m_slots.template resolve<index>(this);
+            }
+        }
+        template<class Type, int ID = 0>
+        [[nodiscard]] Type* resolveBorrowed()
+        {
+            constexpr size_t index = Slots::template indexOf<Type, ID>;
+            if constexpr (index == Slots::npos) {
+                return m_container->resolveBorrowed<Type, ID>();
+            } else {
+                return m_slots.template resolveBorrowed<index>(this);
+            }
+        }
+
+        template<class Type>
+        void inject(Type* value)
+        {
+            if constexpr (detail::AutoInjectable<Type>) {
+                if (value) {
+                    detail::AutoInjector<Type>{}.onInject(value, this);
+                }
+            }
+            if constexpr (detail::TraitsInjectable<Type, HybridInjector>) {
+                if (value) {
+                    InjectTraits<Type>{}.onInject(value, this);
+                }
+            } else if constexpr (detail::TraitsInjectable<Type>) {
+                if (value) {
+                    InjectTraits<Type>{}.onInject(value, m_container.get());
+                }
+            }
+        }
+
+        bool seal()
+        {
+            return m_container->freeze();
+        }
+    private:
+        std::shared_ptr<Container> m_container;
+        Slots m_slots;
+    };
 
     //----------------------------------------
     // Auto Injector
     //----------------------------------------
     namespace detail
     {
-#if __clang__
-        inline constexpr size_t AUTO_INJECT_MAX_LINES = 256;
-#else
-        inline constexpr size_t AUTO_INJECT_MAX_LINES = 500;
-#endif
-        template<size_t Line>
+        // INJECT lines are found through a 16-ary tree of markers, one per level per INJECT,
+        // so discovery probes 16 children of each marked block instead of every line
+        inline constexpr size_t AUTO_INJECT_FANOUT_BITS = 4;
+        inline constexpr size_t AUTO_INJECT_LEVELS = 6;
+        inline constexpr size_t AUTO_INJECT_MAX_LINES = size_t{ 1 } << (AUTO_INJECT_FANOUT_BITS * AUTO_INJECT_LEVELS);
+
+        /// <summary>
+        /// Marker of an INJECT in the Index-th block of Level (blocks of 16^Level lines)
+        /// Each INJECT declares a hidden friend taking one for each level; argument dependent lookup finds it through Type.
+        /// </summary>
+        template<class Type, size_t Level, size_t Index>
+        struct AutoInjectMarker {};
+
+        template<class Type, size_t Level, size_t Index>
+        concept AutoInjectMarked = requires(AutoInjectMarker<Type, Level, Index> marker)
+        {
+            emaject_auto_inject_marker(marker);
+        };
+
+        template<size_t Line, class Resolver = Container>
         struct AutoInjectLine
         {
-            Container* container;
+            Resolver* container;
         };
 
-        template<class Type, size_t LineNum>
-        concept AutoInjectCallable = requires(Type t, AutoInjectLine<LineNum> l)
+        /// <summary>
+        /// Asks the INJECT at Line of Type for the bindings it resolves, without an instance
+        /// </summary>
+        template<class Type>
+        struct DependencyProbe
+        {
+            using type = Type;
+        };
+        template<size_t Line, class Collector>
+        struct DependencyLine
         {
-            t | l;
+            Collector* collector;
         };
 
+        template<class T, size_t Line>
+        struct IsAutoInjectLine : std::false_type {};
+
+        template<size_t Line, class Resolver>
+        struct IsAutoInjectLine<AutoInjectLine<Line, Resolver>, Line> : std::true_type {};
+
+        template<class T, size_t Line>
+        concept AutoInjectLineOf = IsAutoInjectLine<std::remove_cvref_t<T>, Line>::value;
+
+        template<class T, size_t Line>
+        struct IsDependencyLine : std::false_type {};
+
+        template<size_t Line, class Collector>
+        struct IsDependencyLine<DependencyLine<Line, Collector>, Line> : std::true_type {};
+
+        template<class T, size_t Line>
+        concept DependencyLineOf = IsDependencyLine<std::remove_cvref_t<T>, Line>::value;
+
         template <size_t... As, size_t... Bs>
         constexpr std::index_sequence<As..., Bs...> operator+(std::index_sequence<As...>, std::index_sequence<Bs...>)
         {
             return {};
         }
-        template <class Type, size_t LineNum>
-        constexpr auto filter_seq()
+        template <class Type, size_t Level, size_t Index>
+        constexpr auto find_inject_lines();
+
+        template <class Type, size_t Level, size_t Base, size_t ...Seq>
+        constexpr auto find_inject_children(std::index_sequence<Seq...>)
+        {
+            return (find_inject_lines<Type, Level, Base + Seq>() + ...);
+        }
+        template <class Type, size_t Level, size_t Index>
+        constexpr auto find_inject_lines()
         {
-            if constexpr (AutoInjectCallable<Type, LineNum>) {
-                return std::index_sequence<LineNum>{};
-            } else {
+            if constexpr (!AutoInjectMarked<Type, Level, Index>) {
                 return std::index_sequence<>{};
+            } else if constexpr (Level == 0) {
+                return std::index_sequence<Index>{};
+            } else {
+                return find_inject_children<Type, Level - 1, (Index << AUTO_INJECT_FANOUT_BITS)>(
+                    std::make_index_sequence<size_t{ 1 } << AUTO_INJECT_FANOUT_BITS>()
+                );
             }
         }
-        template <class Type, size_t ...Seq>
-        constexpr auto make_sequence_impl(std::index_sequence<Seq...>)
-        {
-            return (filter_seq<Type, Seq>() + ...);
-        }
 
+        /// <summary>
+        /// Lines of the INJECTs of Type in ascending order
+        /// </summary>
         template <class Type>
         constexpr auto make_sequence()
         {
-            return make_sequence_impl<Type>(std::make_index_sequence<AUTO_INJECT_MAX_LINES>());
+            return find_inject_children<Type, AUTO_INJECT_LEVELS - 1, 0>(
+                std::make_index_sequence<size_t{ 1 } << AUTO_INJECT_FANOUT_BITS>()
+            );
         }
 
         template<class Type>
         concept IsAutoInjectable = decltype(make_sequence<Type>())::size() > 0;
 
-        template<IsAutoInjectable Type, size_t LineNum>
-        void auto_inject(Type& ret, Container* c)
+        template<IsAutoInjectable Type, size_t LineNum, class Resolver>
+        void auto_inject(Type& ret, Resolver* c)
         {
-            ret | AutoInjectLine<LineNum>{c};
+            ret | AutoInjectLine<LineNum, Resolver>{c};
         }
-        template<IsAutoInjectable Type, size_t ...Seq>
-        void auto_inject_all_impl(Type& ret, Container* c, std::index_sequence<Seq...>)
+        template<IsAutoInjectable Type, class Resolver, size_t ...Seq>
+        void auto_inject_all_impl(Type& ret, Resolver* c, std::index_sequence<Seq...>)
         {
             (auto_inject<Type, Seq>(ret, c), ...);
         }
-        template<IsAutoInjectable Type>
-        void auto_inject_all(Type& ret, Container* c)
+        template<IsAutoInjectable Type, class Resolver>
+        void auto_inject_all(Type& ret, Resolver* c)
         {
             auto_inject_all_impl(ret, c, make_sequence<Type>());
         }
+        template<IsAutoInjectable Type, class Collector, size_t ...Seq>
+        void auto_depend_all_impl(Collector* c, std::index_sequence<Seq...>)
+        {
+            constexpr DependencyProbe<Type> probe{};
+            ((probe | DependencyLine<Seq, Collector>{c}), ...);
+        }
 
         template<class Type>
         struct AutoInjector
@@ -468,10 +3422,16 @@ namespace emaject
         template<IsAutoInjectable Type>
         struct AutoInjector<Type>
         {
-            void onInject(Type* value, Container* c)
+            template<class Resolver>
+            void onInject(Type* value, Resolver* c)
             {
                 detail::auto_inject_all(*value, c);
             }
+            template<class Collector>
+            void depend(Collector* c)
+            {
+                detail::auto_depend_all_impl<Type>(c, make_sequence<Type>());
+            }
         };
 
         template<class T, auto MemP>
@@ -521,40 +3481,61 @@ namespace emaject
                         }
                     }
                 };
-                template<size_t Index>
-                auto resolve(Container* c)
+                template<size_t Index, class Resolver>
+                auto resolve(Resolver* c)
                 {
-                    return c->resolve<typename TypeId<Index>::type, TypeId<Index>::id()>();
+                    return detail::resolve_for<std::tuple_element_t<Index, resolves_type>, TypeId<Index>::id()>(c);
                 }
-                template<size_t... Seq>
-                auto onInject(Type* value, Container* c, std::index_sequence<Seq...>)
+                template<class Resolver, size_t... Seq>
+                auto onInject(Type* value, Resolver* c, std::index_sequence<Seq...>)
                 {
                     return (value->*MemP)(resolve<Seq>(c)...);
                 }
-                auto onInject(Type* value, Container* c)
+                template<class Resolver>
+                auto onInject(Type* value, Resolver* c)
                 {
                     return onInject(value, c, std::make_index_sequence<sizeof...(Args)>());
                 }
+                template<class Collector, size_t... Seq>
+                void depend(Collector* c, std::index_sequence<Seq...>)
+                {
+                    (detail::depend_for<std::tuple_element_t<Seq, resolves_type>, TypeId<Seq>::id()>(c), ...);
+                }
             };
             using Type = typename InjectedType<decltype(MemP), MemP>::type;
 
-            auto onInject(Type* t, Container* c)
+            template<class Resolver>
+            auto onInject(Type* t, Resolver* c)
             {
                 return impl<decltype(MemP), MemP>{}.onInject(t, c);
             }
+            // Owner names Type in the signature: GCC gives a function templated only on a member pointer of a class
+            // in an anonymous namespace external linkage, so same-named members of two TUs would share one definition
+            template<class Collector, class Owner = Type>
+            void depend(Collector* c)
+            {
+                impl<decltype(MemP), MemP>{}.depend(c, std::make_index_sequence<std::tuple_size_v<typename impl<decltype(MemP), MemP>::resolves_type>>());
+            }
         };
         template<auto MemP, int ID>
         struct FieldInjector
         {
             using Type = typename InjectedType<decltype(MemP), MemP>::type;
 
-            void onInject(Type* t, Container* c)
+            template<class Resolver>
+            void onInject(Type* t, Resolver* c)
             {
-                t->*MemP = c->resolve<typename std::decay_t<decltype(t->*MemP)>::element_type, ID>();
+                t->*MemP = detail::resolve_for<decltype(t->*MemP), ID>(c);
+            }
+            // Owner keeps this TU-local for a Type in an anonymous namespace. see MethodInjector::depend
+            template<class Collector, class Owner = Type>
+            void depend(Collector* c)
+            {
+                detail::depend_for<decltype(std::declval<Type&>().*MemP), ID>(c);
             }
         };
-        template<class Type, auto MemP, int ID = 0, int... IDs>
-        void AutoInject(Type* value, Container* c)
+        template<class Type, auto MemP, int ID = 0, int... IDs, class Resolver>
+        void AutoInject(Type* value, Resolver* c)
         {
             if constexpr (::emaject::detail::MethodInjectable<Type, MemP>) {
                 MethodInjector<MemP, ID, IDs...>{}.onInject(value, c);
@@ -562,26 +3543,57 @@ namespace emaject
                 FieldInjector<MemP, ID>{}.onInject(value, c);
             }
         }
+        template<class Type, auto MemP, int ID = 0, int... IDs, class Collector>
+        void AutoDepend(Collector* c)
+        {
+            if constexpr (::emaject::detail::MethodInjectable<Type, MemP>) {
+                MethodInjector<MemP, ID, IDs...>{}.depend(c);
+            } else {
+                FieldInjector<MemP, ID>{}.depend(c);
+            }
+        }
     }
 }
 
 //----------------------------------------
 // Macro
 //----------------------------------------
+#define INJECT_MARKER_IMPL(line, level) \
+template<class EmajectT> friend void emaject_auto_inject_marker(\
+    ::emaject::detail::AutoInjectMarker<EmajectT, level, ((line) >> (level * ::emaject::detail::AUTO_INJECT_FANOUT_BITS))>\
+);
+#define INJECT_MARKERS_IMPL(line) \
+INJECT_MARKER_IMPL(line, 0)\
+INJECT_MARKER_IMPL(line, 1)\
+INJECT_MARKER_IMPL(line, 2)\
+INJECT_MARKER_IMPL(line, 3)\
+INJECT_MARKER_IMPL(line, 4)\
+INJECT_MARKER_IMPL(line, 5)
+
 #if _MSC_VER
 #define INJECT_IMPL(value, line, ...) ]]\
-friend auto operator|(auto& a, const ::emaject::detail::AutoInjectLine<line>& l){\
+friend auto operator|(auto& a, const ::emaject::detail::AutoInjectLineOf<line> auto& l){\
     static_assert(line < ::emaject::detail::AUTO_INJECT_MAX_LINES);\
     using ThisType = std::decay_t<decltype(a)>;\
     ::emaject::detail::AutoInject<ThisType, &ThisType::value, __VA_ARGS__>(&a, l.container);\
-}[[
+}\
+friend void operator|(const auto& probe, const ::emaject::detail::DependencyLineOf<line> auto& l){\
+    using ThisType = typename std::decay_t<decltype(probe)>::type;\
+    ::emaject::detail::AutoDepend<ThisType, &ThisType::value, __VA_ARGS__>(l.collector);\
+}\
+INJECT_MARKERS_IMPL(line)[[
 #else
 #define INJECT_IMPL(value, line, ...) ]]\
-friend auto operator|(auto& a, const ::emaject::detail::AutoInjectLine<line>& l){\
+friend auto operator|(auto& a, const ::emaject::detail::AutoInjectLineOf<line> auto& l){\
     static_assert(line < ::emaject::detail::AUTO_INJECT_MAX_LINES);\
     using ThisType = std::decay_t<decltype(a)>;\
     ::emaject::detail::AutoInject<ThisType, &ThisType::value __VA_OPT__(,) __VA_ARGS__>(&a, l.container);\
-}[[
+}\
+friend void operator|(const auto& probe, const ::emaject::detail::DependencyLineOf<line> auto& l){\
+    using ThisType = typename std::decay_t<decltype(probe)>::type;\
+    ::emaject::detail::AutoDepend<ThisType, &ThisType::value __VA_OPT__(,) __VA_ARGS__>(l.collector);\
+}\
+INJECT_MARKERS_IMPL(line)[[
 #endif
 #define INJECT(value, ...) INJECT_IMPL(value, __LINE__, __VA_ARGS__)
 
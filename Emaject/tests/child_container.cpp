@@ -0,0 +1,123 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    struct Session
+    {
+        int id = 0;
+    };
+
+    class Handler
+    {
+    public:
+        INJECT_CTOR(Handler(std::shared_ptr<ICounter> counter, std::shared_ptr<Session> session)) :
+            counter(counter),
+            session(session)
+        {}
+        std::shared_ptr<ICounter> counter;
+        std::shared_ptr<Session> session;
+    };
+
+    class SessionView
+    {
+    public:
+        [[INJECT(session)]]
+        std::shared_ptr<Session> session;
+    };
+
+    struct AppInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asCached();
+            c->bind<Handler>()
+                .asTransient();
+            c->bind<SessionView>()
+                .asCached();
+        }
+    };
+
+    TEST_CASE("child_container")
+    {
+        Injector injector;
+        injector.install<AppInstaller>();
+
+        auto child = injector.createChild();
+        REQUIRE(child.has_value());
+        child->install([](Container* c) {
+            c->bind<Session>()
+                .withArgs(Session{ 1 })
+                .asCached();
+        });
+        {
+            // parent bindings are shared
+            REQUIRE(child->resolve<ICounter>() == injector.resolve<ICounter>());
+            REQUIRE(child->resolve<ICounter>()->countUp() == 1);
+
+            // child bindings aren't visible from the parent
+            REQUIRE(child->resolve<Session>()->id == 1);
+            REQUIRE(injector.resolve<Session>() == nullptr);
+        }
+        {
+            // the parent is sealed
+            injector.install([](Container* c) {
+                REQUIRE_FALSE(c->bind<Session>().asCached());
+            });
+        }
+        {
+            // a parent Transient is built with the child resolving it
+            REQUIRE(child->resolve<Handler>()->session == child->resolve<Session>());
+
+            // a parent Cached binding is built with the parent and doesn't capture child bindings
+            REQUIRE(child->resolve<SessionView>()->session == nullptr);
+            REQUIRE(child->resolve<SessionView>() == injector.resolve<SessionView>());
+
+            // instantiate from the child sees both
+            auto handler = child->instantiate<Handler>();
+            REQUIRE(handler->counter == injector.resolve<ICounter>());
+            REQUIRE(handler->session == child->resolve<Session>());
+        }
+        {
+            // a grandchild can shadow parent bindings
+            auto grandchild = child->createChild();
+            REQUIRE(grandchild.has_value());
+            grandchild->install([](Container* c) {
+                c->bind<ICounter>()
+                    .to<Counter>()
+                    .asCached();
+            });
+            REQUIRE(grandchild->resolve<ICounter>() != injector.resolve<ICounter>());
+            REQUIRE(grandchild->resolve<Session>() == child->resolve<Session>());
+        }
+        {
+            // containers not owned by shared_ptr can't have children
+            Container container;
+            REQUIRE(container.createChild() == nullptr);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <Emaject.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    std::atomic<int> g_constructCount = 0;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class SlowCounter : public ICounter
+    {
+        std::atomic<int> m_count = 0;
+    public:
+        SlowCounter()
+        {
+            ++g_constructCount;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class SlowSingleCounter : public SlowCounter
+    {};
+
+    struct CounterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<SlowCounter>()
+                .asCached();
+
+            c->bind<ICounter, 1>()
+                .to<SlowSingleCounter>()
+                .asSingle();
+        }
+    };
+
+    template<class Type, int ID = 0>
+    std::vector<std::shared_ptr<Type>> resolveConcurrently(Injector& injector, size_t threadCount)
+    {
+        std::vector<std::shared_ptr<Type>> results(threadCount);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i] {
+                results[i] = injector.resolve<Type, ID>();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return results;
+    }
+
+    TEST_CASE("concurrent_resolve")
+    {
+        Injector injector;
+        injector.install<CounterInstaller>();
+
+        constexpr size_t threadCount = 16;
+        {
+            g_constructCount = 0;
+            auto counters = resolveConcurrently<ICounter>(injector, threadCount);
+            REQUIRE(g_constructCount == 1);
+            for (const auto& counter : counters) {
+                REQUIRE(counter == counters.front());
+            }
+        }
+        {
+            g_constructCount = 0;
+            auto counters = resolveConcurrently<ICounter, 1>(injector, threadCount);
+            REQUIRE(g_constructCount == 1);
+            for (const auto& counter : counters) {
+                REQUIRE(counter == counters.front());
+            }
+        }
+    }
+}
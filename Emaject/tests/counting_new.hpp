@@ -0,0 +1,79 @@
+#pragma once
+// Counting allocator shared by the allocation test and the runtime benchmarks.
+// It replaces the global operator new, so include it from exactly one translation unit per executable.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#define EMAJECT_COUNTING_NOINLINE __declspec(noinline)
+#else
+#define EMAJECT_COUNTING_NOINLINE [[gnu::noinline]]
+#endif
+
+namespace emaject::counting
+{
+    /// <summary>
+    /// Heap allocations and requested bytes of the calling thread
+    /// </summary>
+    inline thread_local std::size_t t_allocations = 0;
+    inline thread_local std::size_t t_allocatedBytes = 0;
+
+    inline void* aligned_malloc(std::size_t size, std::align_val_t align)
+    {
+        const auto alignment = static_cast<std::size_t>(align);
+        size = size ? size : 1;
+#if defined(_MSC_VER)
+        return _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc needs a size that's a multiple of the alignment
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+    inline void aligned_free(void* p)
+    {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+// count every heap allocation of the binary
+// none of them is inlined, so GCC doesn't pair malloc and free across them (-Wmismatched-new-delete)
+EMAJECT_COUNTING_NOINLINE void* operator new(std::size_t size)
+{
+    ++emaject::counting::t_allocations;
+    emaject::counting::t_allocatedBytes += size;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+EMAJECT_COUNTING_NOINLINE void* operator new(std::size_t size, std::align_val_t align)
+{
+    ++emaject::counting::t_allocations;
+    emaject::counting::t_allocatedBytes += size;
+    if (void* p = emaject::counting::aligned_malloc(size, align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+EMAJECT_COUNTING_NOINLINE void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+EMAJECT_COUNTING_NOINLINE void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+EMAJECT_COUNTING_NOINLINE void operator delete(void* p, std::align_val_t) noexcept
+{
+    emaject::counting::aligned_free(p);
+}
+EMAJECT_COUNTING_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    emaject::counting::aligned_free(p);
+}
@@ -0,0 +1,59 @@
+#include <Emaject.hpp>
+
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::detail::FlatMap;
+    using emaject::detail::TypeId;
+
+    TEST_CASE("flat_map")
+    {
+        constexpr size_t count = 10000;
+        std::vector<char> storage(count * 2);
+        auto key = [&](size_t i) -> TypeId {
+            return &storage[i];
+        };
+
+        FlatMap<TypeId, size_t> map;
+        REQUIRE(map.empty());
+        REQUIRE(map.find(key(0)) == nullptr);
+
+        bool allInserted = true;
+        for (size_t i = 0; i < count; ++i) {
+            auto [value, inserted] = map.tryEmplace(key(i), i);
+            allInserted &= inserted && *value == i;
+        }
+        REQUIRE(allInserted);
+        REQUIRE(map.size() == count);
+        {
+            // already exists
+            auto [value, inserted] = map.tryEmplace(key(10), 0u);
+            REQUIRE_FALSE(inserted);
+            REQUIRE(*value == 10);
+        }
+        bool allFound = true;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t* value = map.find(key(i));
+            allFound &= value != nullptr && *value == i;
+        }
+        REQUIRE(allFound);
+
+        bool allMissed = true;
+        for (size_t i = count; i < count * 2; ++i) {
+            allMissed &= map.find(key(i)) == nullptr;
+        }
+        REQUIRE(allMissed);
+
+        size_t visited = 0;
+        map.forEach([&](TypeId, size_t&) {
+            ++visited;
+        });
+        REQUIRE(visited == count);
+
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(map.find(key(0)) == nullptr);
+    }
+}
@@ -1,5 +1,6 @@
 #include <Emaject.hpp>
 
+#include <array>
 #include <string_view>
 #include "catch.hpp"
 
@@ -49,6 +50,24 @@ namespace
                     return std::make_shared<Foo>(c->resolve<IFoo, 0>()->value() + 1);
                 })
                 .asCached();
+
+            // Move only Factory
+            c->bind<IFoo, 2>()
+                .toSelf()
+                .fromFactory([value = std::make_unique<int>(3)] {
+                    return std::make_shared<Foo>(*value);
+                })
+                .asTransient();
+
+            // Large Factory
+            std::array<int, 64> values{};
+            values.back() = 4;
+            c->bind<IFoo, 3>()
+                .toSelf()
+                .fromFactory([values] {
+                    return std::make_shared<Foo>(values.back());
+                })
+                .asTransient();
         }
     };
     TEST_CASE("from_factory")
@@ -62,5 +81,11 @@ namespace
             REQUIRE(foo0->value() == 1);
             REQUIRE(foo1->value() == 2);
         }
+        {
+            auto foo2 = injector.resolve<IFoo, 2>();
+            auto foo3 = injector.resolve<IFoo, 3>();
+            REQUIRE(foo2->value() == 3);
+            REQUIRE(foo3->value() == 4);
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Bind;
+    using emaject::Container;
+    using emaject::HybridInjector;
+    using emaject::IInstaller;
+    using emaject::ScopeKind;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class SingleCounter : public Counter
+    {};
+
+    class IPlugin
+    {
+    public:
+        virtual ~IPlugin() = default;
+        virtual std::shared_ptr<ICounter> counter() const = 0;
+    };
+
+    class Plugin : public IPlugin
+    {
+    public:
+        std::shared_ptr<ICounter> counter() const override
+        {
+            return m_counter;
+        }
+    private:
+        [[INJECT(m_counter)]]
+        std::shared_ptr<ICounter> m_counter;
+    };
+
+    class User
+    {
+    public:
+        [[INJECT(counter)]]
+        std::shared_ptr<ICounter> counter;
+
+        [[INJECT(plugin)]]
+        std::shared_ptr<IPlugin> plugin;
+
+        std::shared_ptr<ICounter> traitsCounter;
+    };
+
+    class Borrower
+    {
+    public:
+        ICounter* counter = nullptr;
+        ICounter* single = nullptr;
+    };
+
+    struct PluginInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<IPlugin>()
+                .to<Plugin>()
+                .asCached();
+        }
+    };
+}
+
+namespace emaject
+{
+    template<>
+    struct InjectTraits<User>
+    {
+        void onInject(User* value, Container* c)
+        {
+            value->traitsCounter = c->resolve<ICounter>();
+        }
+    };
+}
+
+namespace
+{
+    using Injector = HybridInjector<
+        Bind<ICounter, Counter, ScopeKind::Cached>,
+        Bind<ICounter, SingleCounter, ScopeKind::Single, 1>
+    >;
+
+    TEST_CASE("hybrid_injector")
+    {
+        Injector injector;
+        injector.install<PluginInstaller>();
+
+        auto counter = injector.resolve<ICounter>(); // static
+        REQUIRE(counter->countUp() == 1);
+        REQUIRE(injector.resolveBorrowed<ICounter>() == counter.get());
+
+        auto plugin = injector.resolve<IPlugin>(); // runtime
+        REQUIRE(plugin != nullptr);
+        REQUIRE(plugin->counter() == counter);
+
+        auto user = injector.instantiate<User>();
+        REQUIRE(user->counter == counter);
+        REQUIRE(user->plugin == plugin);
+        REQUIRE(user->traitsCounter == counter);
+
+        // static bindings keep their scope inside the Container
+        bool rebound = true;
+        injector.install([&](Container* c) {
+            rebound = c->bind<ICounter, 2>()
+                .to<SingleCounter>()
+                .asTransient();
+            (void)c->bind<Borrower>()
+                .fromFactory([](Container* c) {
+                    auto borrower = std::make_shared<Borrower>();
+                    borrower->counter = c->resolveBorrowed<ICounter>();
+                    borrower->single = c->resolveBorrowed<ICounter, 1>();
+                    return borrower;
+                })
+                .asTransient();
+        });
+        REQUIRE_FALSE(rebound);
+        auto borrower = injector.resolve<Borrower>();
+        REQUIRE(borrower->counter == counter.get());
+        REQUIRE(borrower->single != nullptr);
+        REQUIRE(borrower->single == injector.resolveBorrowed<ICounter, 1>());
+
+        REQUIRE(injector.seal());
+        REQUIRE(injector.resolve<IPlugin>() == plugin);
+    }
+}
@@ -0,0 +1,68 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class IPrinter
+    {
+    public:
+        virtual ~IPrinter() = default;
+        virtual std::string print() const = 0;
+    };
+
+    class Printer : public IPrinter
+    {
+    public:
+        std::string print() const override
+        {
+            return "Printer";
+        }
+    };
+
+    struct PrinterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<IPrinter>()
+                .to<Printer>()
+                .asCached();
+        }
+    };
+
+// INJECT isn't limited to the first lines of a file
+#line 70000
+    class FarAway
+    {
+    public:
+        [[INJECT(first)]]
+        std::shared_ptr<IPrinter> first;
+
+        std::shared_ptr<IPrinter> second;
+    private:
+        [[INJECT(setSecond)]]
+        void setSecond(std::shared_ptr<IPrinter> printer)
+        {
+            second = printer;
+        }
+    public:
+#line 1000000
+        [[INJECT(third)]]
+        std::shared_ptr<IPrinter> third;
+    };
+
+    TEST_CASE("inject_line")
+    {
+        Injector injector;
+        injector.install<PrinterInstaller>();
+
+        auto farAway = injector.instantiate<FarAway>();
+        REQUIRE(farAway->first->print() == "Printer");
+        REQUIRE(farAway->second == farAway->first);
+        REQUIRE(farAway->third == farAway->first);
+    }
+}
@@ -0,0 +1,88 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class Service
+    {
+    public:
+        INJECT_CTOR(Service(std::shared_ptr<ICounter> counter)) :
+            counter(counter)
+        {}
+        Service() = default;
+
+        std::shared_ptr<ICounter> counter;
+
+        [[INJECT(transient, 1)]]
+        std::shared_ptr<ICounter> transient;
+    };
+
+    struct CounterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asCached();
+        }
+    };
+
+    TEST_CASE("injection_plan")
+    {
+        Injector injector;
+        injector.install<CounterInstaller>();
+
+        {
+            // first call records the plan, later calls replay it
+            bool ok = true;
+            for (int i = 1; i <= 3; ++i) {
+                auto service = injector.instantiate<Service>();
+                ok = ok && service->counter && service->counter->countUp() == i;
+                ok = ok && service->transient == nullptr;
+            }
+            REQUIRE(ok);
+        }
+        {
+            // binding after the plan is recorded is still seen
+            injector.install([](Container* c) {
+                c->bind<ICounter, 1>()
+                    .to<Counter>()
+                    .asTransient();
+            });
+            auto service = injector.instantiate<Service>();
+            REQUIRE(service->transient != nullptr);
+            REQUIRE(service->transient != injector.instantiate<Service>()->transient);
+            REQUIRE(service->counter == injector.resolve<ICounter>());
+        }
+        {
+            // explicit arguments use their own plan
+            auto service = injector.instantiate<Service>(nullptr);
+            REQUIRE(service->counter == nullptr);
+            REQUIRE(service->transient != nullptr);
+
+            REQUIRE(injector.instantiate<Service>()->counter != nullptr);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#include <Emaject.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+    using emaject::Lazy;
+
+    std::atomic<int> g_constructCount = 0;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        std::atomic<int> m_count = 0;
+    public:
+        Counter()
+        {
+            ++g_constructCount;
+        }
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class Handler
+    {
+    public:
+        INJECT_CTOR(Handler(Lazy<ICounter> ctor)) :
+            ctor(ctor)
+        {}
+
+        Lazy<ICounter> ctor;
+
+        [[INJECT(field)]]
+        Lazy<ICounter> field;
+
+        [[INJECT(missing, 1)]]
+        Lazy<ICounter> missing;
+
+        Lazy<ICounter> method;
+        std::shared_ptr<ICounter> eager;
+    private:
+        [[INJECT(setCounters)]]
+        void setCounters(Lazy<ICounter> lazy, std::shared_ptr<ICounter> counter)
+        {
+            method = lazy;
+            eager = counter;
+        }
+    };
+
+    struct CounterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asTransient();
+        }
+    };
+
+    TEST_CASE("lazy")
+    {
+        Injector injector;
+        injector.install<CounterInstaller>();
+
+        g_constructCount = 0;
+        auto handler = injector.instantiate<Handler>();
+        // only the shared_ptr parameter is resolved up front
+        REQUIRE(g_constructCount == 1);
+        REQUIRE_FALSE(handler->field.isResolved());
+
+        REQUIRE(handler->field->countUp() == 1);
+        REQUIRE(handler->field->countUp() == 2);
+        REQUIRE(handler->field.isResolved());
+        REQUIRE(g_constructCount == 2);
+
+        REQUIRE(handler->ctor);
+        REQUIRE(handler->method);
+        REQUIRE(g_constructCount == 4);
+
+        // nothing bound: stays empty
+        REQUIRE_FALSE(handler->missing);
+        REQUIRE(handler->missing.get() == nullptr);
+        {
+            // concurrent first use resolves once
+            auto other = injector.instantiate<Handler>();
+            g_constructCount = 0;
+            std::vector<ICounter*> results(8);
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < results.size(); ++i) {
+                threads.emplace_back([&, i] {
+                    results[i] = other->field.get();
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            REQUIRE(g_constructCount == 1);
+            REQUIRE(std::all_of(results.begin(), results.end(), [&](ICounter* c) { return c == results[0]; }));
+
+            // copies share the instance
+            Lazy<ICounter> copy = other->field;
+            std::shared_ptr<ICounter> shared = copy;
+            REQUIRE(shared.get() == results[0]);
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include <Emaject.hpp>
+
+#include <numeric>
+#include "catch.hpp"
+
+// built with EMAJECT_ENABLE_METRICS=1 by EmajectMetricsTests only, so every test of a binary sees the same layout
+#if EMAJECT_ENABLE_METRICS
+namespace
+{
+    using emaject::BindingMetrics;
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class IPrinter
+    {
+    public:
+        virtual ~IPrinter() = default;
+    };
+
+    class Printer : public IPrinter
+    {};
+
+    class Counter
+    {
+    public:
+        int count = 0;
+    };
+
+    class RequestContext
+    {};
+
+    class HelloWorld
+    {
+    public:
+        [[INJECT(printer)]]
+        std::shared_ptr<IPrinter> printer;
+    };
+
+    struct MetricsInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<IPrinter>()
+                .to<Printer>()
+                .asCached();
+            c->bind<IPrinter, 1>()
+                .to<Printer>()
+                .asTransient();
+            c->bind<Counter>()
+                .asPooled(1);
+            c->bind<RequestContext>()
+                .asScoped();
+        }
+    };
+
+    const BindingMetrics& find(const std::vector<BindingMetrics>& metrics, std::string_view type, int id = 0)
+    {
+        for (const BindingMetrics& m : metrics) {
+            if (m.type.find(type) != std::string_view::npos && m.id == id) {
+                return m;
+            }
+        }
+        FAIL("no metrics for " << type);
+        return metrics.front();
+    }
+
+    std::uint64_t histogram_total(const BindingMetrics& m)
+    {
+        return std::accumulate(m.factoryLatency.begin(), m.factoryLatency.end(), std::uint64_t{ 0 });
+    }
+
+    TEST_CASE("metrics")
+    {
+        Injector injector;
+        injector.install<MetricsInstaller>();
+
+        for (int i = 0; i < 3; ++i) {
+            (void)injector.resolve<IPrinter>();
+            (void)injector.resolve<IPrinter, 1>();
+        }
+        (void)injector.instantiate<HelloWorld>();
+        (void)injector.resolve<Counter>();
+        (void)injector.resolve<Counter>();
+        {
+            auto scope = injector.beginScope();
+            (void)scope->resolve<RequestContext>();
+            (void)scope->resolve<RequestContext>();
+        }
+
+        const auto metrics = injector.metrics();
+        REQUIRE(metrics.size() == 4);
+        {
+            const BindingMetrics& cached = find(metrics, "IPrinter");
+            REQUIRE(cached.to.find("Printer") != std::string_view::npos);
+            REQUIRE(cached.kind == emaject::ScopeKind::Cached);
+            // 3 resolves and the field of HelloWorld
+            REQUIRE(cached.resolves == 4);
+            REQUIRE(cached.cacheHits == 3);
+            REQUIRE(cached.factoryCalls == 1);
+            REQUIRE(cached.transientConstructions == 0);
+            REQUIRE(histogram_total(cached) == 1);
+        }
+        {
+            const BindingMetrics& transient = find(metrics, "IPrinter", 1);
+            REQUIRE(transient.resolves == 3);
+            REQUIRE(transient.cacheHits == 0);
+            REQUIRE(transient.factoryCalls == 3);
+            REQUIRE(transient.transientConstructions == 3);
+            REQUIRE(histogram_total(transient) == 3);
+        }
+        {
+            // the first instance went back to the pool and was reused
+            const BindingMetrics& pooled = find(metrics, "Counter");
+            REQUIRE(pooled.resolves == 2);
+            REQUIRE(pooled.cacheHits == 1);
+            REQUIRE(pooled.factoryCalls == 1);
+        }
+        {
+            const BindingMetrics& scoped = find(metrics, "RequestContext");
+            REQUIRE(scoped.resolves == 2);
+            REQUIRE(scoped.cacheHits == 1);
+            REQUIRE(scoped.factoryCalls == 1);
+        }
+    }
+}
+#endif
@@ -0,0 +1,103 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class Parser
+    {
+    public:
+        [[INJECT(counter)]]
+        std::shared_ptr<ICounter> counter;
+
+        std::string buffer;
+    };
+
+    struct PooledInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asPooled(1);
+
+            c->bind<Parser>()
+                .asPooled(4, [](Parser& parser) {
+                    parser.buffer.clear();
+                    parser.counter = nullptr;
+                    return true; // inject again
+                });
+        }
+    };
+
+    TEST_CASE("pooled")
+    {
+        Injector injector;
+        injector.install<PooledInstaller>();
+        {
+            ICounter* first = nullptr;
+            {
+                auto counter = injector.resolve<ICounter>();
+                REQUIRE(counter->countUp() == 1);
+                first = counter.get();
+            }
+            // released instance is reused
+            auto counter = injector.resolve<ICounter>();
+            REQUIRE(counter.get() == first);
+            REQUIRE(counter->countUp() == 2);
+
+            // nothing idle, so a new one is created
+            auto other = injector.resolve<ICounter>();
+            REQUIRE(other.get() != first);
+            REQUIRE(other->countUp() == 1);
+
+            // pooled instances can't be borrowed
+            REQUIRE(injector.resolveBorrowed<ICounter>() == nullptr);
+        }
+        {
+            Parser* first = nullptr;
+            {
+                auto parser = injector.resolve<Parser>();
+                REQUIRE(parser->counter != nullptr);
+                parser->buffer = "abc";
+                first = parser.get();
+            }
+            // reset and injected again
+            auto parser = injector.resolve<Parser>();
+            REQUIRE(parser.get() == first);
+            REQUIRE(parser->buffer.empty());
+            REQUIRE(parser->counter != nullptr);
+        }
+        {
+            // handles may outlive the injector
+            std::shared_ptr<ICounter> counter;
+            {
+                Injector scoped;
+                scoped.install<PooledInstaller>();
+                counter = scoped.resolve<ICounter>();
+            }
+            REQUIRE(counter->countUp() == 1);
+        }
+    }
+}
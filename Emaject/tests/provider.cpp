@@ -0,0 +1,97 @@
+#include <Emaject.hpp>
+
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+    using emaject::Provider;
+
+    class ITask
+    {
+    public:
+        virtual ~ITask() = default;
+        virtual int run() = 0;
+    };
+
+    class Task : public ITask
+    {
+        int m_count = 0;
+    public:
+        int run() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class BigTask : public Task
+    {};
+
+    class Worker
+    {
+    public:
+        INJECT_CTOR(Worker(Provider<ITask> ctor)) :
+            ctor(ctor)
+        {}
+
+        Provider<ITask> ctor;
+
+        [[INJECT(big)]]
+        Provider<ITask, 1> big;
+
+        [[INJECT(missing)]]
+        Provider<ITask, 2> missing;
+    };
+
+    struct TaskInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ITask>()
+                .to<Task>()
+                .asTransient();
+            c->bind<ITask, 1>()
+                .to<BigTask>()
+                .asCached();
+        }
+    };
+
+    TEST_CASE("provider")
+    {
+        Injector injector;
+        injector.install<TaskInstaller>();
+
+        auto worker = injector.instantiate<Worker>();
+        {
+            // transient: new instance for each get
+            REQUIRE(worker->ctor);
+            auto t0 = worker->ctor.get();
+            auto t1 = worker->ctor();
+            REQUIRE(t0 != t1);
+            REQUIRE(t0->run() == 1);
+            REQUIRE(t1->run() == 1);
+        }
+        {
+            // follows the scope of the binding
+            auto t0 = worker->big.get();
+            REQUIRE(dynamic_cast<BigTask*>(t0.get()) != nullptr);
+            REQUIRE(t0 == worker->big.get());
+            REQUIRE(t0 == injector.resolve<ITask, 1>());
+        }
+        {
+            REQUIRE_FALSE(worker->missing);
+            REQUIRE(worker->missing.get() == nullptr);
+        }
+        {
+            auto provider = injector.provider<ITask>();
+            std::vector<std::shared_ptr<ITask>> tasks;
+            for (int i = 0; i < 100; ++i) {
+                tasks.push_back(provider.get());
+            }
+            REQUIRE(tasks.front() != tasks.back());
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    struct CounterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asCached();
+
+            c->bind<ICounter, 1>()
+                .to<Counter>()
+                .asTransient();
+        }
+    };
+
+    TEST_CASE("resolve_borrowed")
+    {
+        Injector injector;
+        injector.install<CounterInstaller>();
+
+        {
+            ICounter* counter = injector.resolveBorrowed<ICounter>(); // new instance
+            REQUIRE(counter != nullptr);
+            REQUIRE(counter->countUp() == 1);
+        }
+        {
+            ICounter* counter = injector.resolveBorrowed<ICounter>(); // used cache
+            REQUIRE(counter->countUp() == 2);
+            REQUIRE(counter == injector.resolve<ICounter>().get());
+        }
+        {
+            // transient has no owner
+            REQUIRE(injector.resolveBorrowed<ICounter, 1>() == nullptr);
+        }
+        {
+            // not bound
+            REQUIRE(injector.resolveBorrowed<Counter>() == nullptr);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+// replaces the global operator new, so it's built with EMAJECT_TEST_ALLOCATIONS=1 by EmajectAllocationTests only
+#if EMAJECT_TEST_ALLOCATIONS
+#include "counting_new.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+    using emaject::counting::t_allocations;
+
+    class RequestContext
+    {
+    public:
+        int id = 0;
+    };
+
+    class Handler
+    {
+    public:
+        [[INJECT(context)]]
+        std::shared_ptr<RequestContext> context;
+    };
+
+    struct RequestInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<RequestContext>()
+                .asScoped();
+            c->bind<Handler>()
+                .asScoped();
+        }
+    };
+
+    bool runScope(Injector& injector)
+    {
+        auto scope = injector.beginScope();
+        auto handler = scope->resolve<Handler>();
+        return handler && handler->context == scope->resolve<RequestContext>();
+    }
+
+    TEST_CASE("scope_allocation")
+    {
+        Injector injector;
+        injector.install<RequestInstaller>();
+
+        // the first cycles grow the pool, the scope and its plans
+        bool ok = true;
+        for (int i = 0; i < 4; ++i) {
+            ok = runScope(injector) && ok;
+        }
+        REQUIRE(ok);
+
+        const size_t before = t_allocations;
+        for (int i = 0; i < 1000; ++i) {
+            ok = runScope(injector) && ok;
+        }
+        const size_t allocations = t_allocations - before;
+        REQUIRE(ok);
+        REQUIRE(allocations == 0);
+    }
+}
+#endif
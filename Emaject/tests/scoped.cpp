@@ -0,0 +1,129 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+    using emaject::Lazy;
+    using emaject::Provider;
+
+    int g_aliveCount = 0;
+
+    class RequestContext
+    {
+    public:
+        RequestContext()
+        {
+            ++g_aliveCount;
+        }
+        ~RequestContext()
+        {
+            --g_aliveCount;
+        }
+        int countUp()
+        {
+            return ++m_count;
+        }
+    private:
+        int m_count = 0;
+    };
+
+    class Handler
+    {
+    public:
+        [[INJECT(context)]]
+        std::shared_ptr<RequestContext> context;
+    };
+
+    class Dispatcher
+    {
+    public:
+        [[INJECT(contexts)]]
+        Provider<RequestContext> contexts;
+
+        [[INJECT(lazyContext)]]
+        Lazy<RequestContext> lazyContext;
+    };
+
+    struct RequestInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<RequestContext>()
+                .asScoped();
+            c->bind<Handler>()
+                .asScoped();
+            c->bind<Dispatcher>()
+                .asTransient();
+        }
+    };
+
+    TEST_CASE("scoped")
+    {
+        Injector injector;
+        injector.install<RequestInstaller>();
+
+        g_aliveCount = 0;
+        {
+            auto scope = injector.beginScope();
+            REQUIRE(scope.has_value());
+
+            // cached in the scope
+            auto context = scope->resolve<RequestContext>();
+            REQUIRE(context->countUp() == 1);
+            REQUIRE(scope->resolve<RequestContext>()->countUp() == 2);
+            REQUIRE(scope->resolve<Handler>()->context == context);
+            REQUIRE(scope->resolveBorrowed<RequestContext>() == context.get());
+
+            // another scope has its own
+            auto other = injector.beginScope();
+            REQUIRE(other->resolve<RequestContext>() != context);
+            REQUIRE(g_aliveCount == 2);
+        }
+        // released together with the scope
+        REQUIRE(g_aliveCount == 0);
+        {
+            // instances can outlive their scope
+            std::shared_ptr<RequestContext> context;
+            {
+                auto scope = injector.beginScope();
+                context = scope->resolve<RequestContext>();
+            }
+            REQUIRE(g_aliveCount == 1);
+            REQUIRE(context->countUp() == 1);
+        }
+        REQUIRE(g_aliveCount == 0);
+        {
+            // handles escaping a scope don't resolve in the request that reuses it
+            Provider<RequestContext> contexts;
+            Lazy<RequestContext> lazyContext;
+            {
+                auto scope = injector.beginScope();
+                auto dispatcher = scope->resolve<Dispatcher>();
+                REQUIRE(dispatcher->contexts.get() == scope->resolve<RequestContext>());
+                contexts = dispatcher->contexts;
+                lazyContext = dispatcher->lazyContext;
+            }
+            auto next = injector.beginScope();
+            REQUIRE(next->resolve<RequestContext>() != nullptr);
+            REQUIRE(contexts.get() == nullptr);
+            REQUIRE(lazyContext.get() == nullptr);
+            REQUIRE(next->resolve<Dispatcher>()->lazyContext.get() == next->resolve<RequestContext>().get());
+        }
+        {
+            // a nested scope doesn't share the outer one's instances
+            auto scope = injector.beginScope();
+            auto nested = scope->beginScope();
+            REQUIRE(nested->resolve<RequestContext>() != scope->resolve<RequestContext>());
+        }
+        {
+            // without a scope the root caches it
+            auto context = injector.resolve<RequestContext>();
+            REQUIRE(context == injector.resolve<RequestContext>());
+            REQUIRE(context != injector.beginScope()->resolve<RequestContext>());
+        }
+    }
+}
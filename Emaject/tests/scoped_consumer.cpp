@@ -0,0 +1,121 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+    using emaject::Provider;
+
+    class RequestContext
+    {};
+
+    class IHandler
+    {
+    public:
+        virtual ~IHandler() = default;
+        virtual std::shared_ptr<RequestContext> requestContext() const = 0;
+    };
+
+    class Handler : public IHandler
+    {
+    public:
+        std::shared_ptr<RequestContext> requestContext() const override
+        {
+            return context;
+        }
+
+        [[INJECT(context)]]
+        std::shared_ptr<RequestContext> context;
+    };
+
+    class PooledHandler
+    {
+    public:
+        [[INJECT(context)]]
+        std::shared_ptr<RequestContext> context;
+    };
+
+    class Dispatcher
+    {
+    public:
+        [[INJECT(handlers)]]
+        Provider<Handler> handlers;
+    };
+
+    class Registry
+    {
+    public:
+        [[INJECT(context)]]
+        std::shared_ptr<RequestContext> context;
+    };
+
+    struct RequestInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<RequestContext>()
+                .asScoped();
+            c->bind<Handler>()
+                .asTransient();
+            c->bind<IHandler>()
+                .to<Handler>()
+                .fromResolve()
+                .asTransient();
+            c->bind<PooledHandler>()
+                .asPooled(1, [](PooledHandler& handler) {
+                    handler.context = nullptr;
+                    return true; // inject again
+                });
+            c->bind<Dispatcher>()
+                .asTransient();
+            c->bind<Registry>()
+                .asCached();
+        }
+    };
+
+    TEST_CASE("scoped_consumer")
+    {
+        Injector injector;
+        injector.install<RequestInstaller>();
+
+        auto s1 = injector.beginScope();
+        auto s2 = injector.beginScope();
+        const auto c1 = s1->resolve<RequestContext>();
+        const auto c2 = s2->resolve<RequestContext>();
+        REQUIRE(c1 != c2);
+
+        // root-level Transient consumers see the scope they are resolved from
+        REQUIRE(s1->resolve<Handler>()->context == c1);
+        REQUIRE(s2->resolve<Handler>()->context == c2);
+
+        // fromResolve forwards within the scope
+        REQUIRE(s1->resolve<IHandler>()->requestContext() == c1);
+        REQUIRE(s2->resolve<IHandler>()->requestContext() == c2);
+
+        // a Provider injected in a scope resolves in that scope
+        REQUIRE(s1->resolve<Dispatcher>()->handlers.get()->context == c1);
+        REQUIRE(s2->resolve<Dispatcher>()->handlers.get()->context == c2);
+
+        // a pooled instance is injected by the scope acquiring it
+        PooledHandler* first = nullptr;
+        {
+            auto handler = s1->resolve<PooledHandler>();
+            REQUIRE(handler->context == c1);
+            first = handler.get();
+        }
+        {
+            auto handler = s2->resolve<PooledHandler>();
+            REQUIRE(handler.get() == first);
+            REQUIRE(handler->context == c2);
+        }
+
+        // Cached bindings stay in the root graph and don't capture a scope's instance
+        const auto registry = s1->resolve<Registry>();
+        REQUIRE(registry->context != c1);
+        REQUIRE(registry == s2->resolve<Registry>());
+        REQUIRE(registry->context == injector.resolve<RequestContext>());
+    }
+}
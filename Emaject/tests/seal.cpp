@@ -0,0 +1,156 @@
+#include <Emaject.hpp>
+
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    struct CounterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asCached();
+
+            c->bind<ICounter, 1>()
+                .to<Counter>()
+                .asTransient();
+
+            c->bind<ICounter, 2>()
+                .to<ICounter>()
+                .fromResolve<1>()
+                .asTransient();
+        }
+    };
+
+    TEST_CASE("seal")
+    {
+        Injector injector;
+        injector.install<CounterInstaller>();
+        REQUIRE(injector.seal());
+
+        {
+            auto counter = injector.resolve<ICounter>();
+            REQUIRE(counter->countUp() == 1);
+            REQUIRE(injector.resolve<ICounter>() == counter);
+        }
+        {
+            auto counter = injector.resolve<ICounter, 2>();
+            REQUIRE(counter != nullptr);
+            REQUIRE(counter != injector.resolve<ICounter, 1>());
+        }
+        {
+            // not bound
+            REQUIRE(injector.resolve<Counter>() == nullptr);
+        }
+        {
+            // sealed
+            bool bound = true;
+            injector.install([&](Container* c) {
+                bound = c->bind<Counter>().asCached();
+            });
+            REQUIRE_FALSE(bound);
+            REQUIRE(injector.resolve<Counter>() == nullptr);
+        }
+    }
+
+    TEST_CASE("seal_dangling_resolve")
+    {
+        Injector injector;
+        injector.install([](Container* c) {
+            c->bind<ICounter>()
+                .to<ICounter>()
+                .fromResolve<1>()
+                .asCached();
+        });
+        REQUIRE_FALSE(injector.seal());
+
+        injector.install([](Container* c) {
+            c->bind<ICounter, 1>()
+                .to<Counter>()
+                .asCached();
+        });
+        REQUIRE(injector.seal());
+        REQUIRE(injector.resolve<ICounter>() != nullptr);
+    }
+
+    class CounterUser
+    {
+    public:
+        [[INJECT(counter)]]
+        std::shared_ptr<ICounter> counter;
+    };
+
+    TEST_CASE("seal_unbound_inject")
+    {
+        // INJECT dependencies aren't validated, a child may bind them
+        Injector injector;
+        injector.install([](Container* c) {
+            c->bind<CounterUser>()
+                .asTransient();
+        });
+        REQUIRE(injector.seal());
+        REQUIRE(injector.resolve<CounterUser>()->counter == nullptr);
+
+        auto child = injector.createChild();
+        REQUIRE(child.has_value());
+        child->install([](Container* c) {
+            c->bind<ICounter>()
+                .to<Counter>()
+                .asCached();
+        });
+        REQUIRE(child->resolve<CounterUser>()->counter == child->resolve<ICounter>());
+    }
+
+    TEST_CASE("perfect_hash_map")
+    {
+        using emaject::detail::PerfectHashMap;
+        using emaject::detail::TypeId;
+
+        constexpr size_t count = 10000;
+        std::vector<char> storage(count * 2);
+
+        std::vector<std::pair<TypeId, size_t>> items;
+        for (size_t i = 0; i < count; ++i) {
+            items.emplace_back(&storage[i], i);
+        }
+        PerfectHashMap<size_t> map;
+        map.build(items);
+        REQUIRE(map.size() == count);
+
+        bool allFound = true;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t* value = map.find(&storage[i]);
+            allFound &= value != nullptr && *value == i;
+        }
+        REQUIRE(allFound);
+
+        bool allMissed = true;
+        for (size_t i = count; i < count * 2; ++i) {
+            allMissed &= map.find(&storage[i]) == nullptr;
+        }
+        REQUIRE(allMissed);
+    }
+}
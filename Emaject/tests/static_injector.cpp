@@ -0,0 +1,161 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Bind;
+    using emaject::Container;
+    using emaject::ScopeKind;
+    using emaject::StaticInjector;
+
+    class ICounter
+    {
+    public:
+        virtual ~ICounter() = default;
+        virtual int countUp() = 0;
+    };
+
+    class Counter : public ICounter
+    {
+        int m_count = 0;
+    public:
+        int countUp() override
+        {
+            return ++m_count;
+        }
+    };
+
+    class SingleCounter : public Counter
+    {};
+
+    class FieldUser
+    {
+    public:
+        [[INJECT(counter)]]
+        std::shared_ptr<ICounter> counter;
+
+        [[INJECT(transient, 1)]]
+        std::shared_ptr<ICounter> transient;
+    };
+
+    class MethodUser
+    {
+    public:
+        std::shared_ptr<ICounter> counter;
+        std::shared_ptr<ICounter> single;
+    private:
+        [[INJECT(setCounters, 0, 2)]]
+        void setCounters(std::shared_ptr<ICounter> c0, std::shared_ptr<ICounter> c2)
+        {
+            counter = c0;
+            single = c2;
+        }
+    };
+
+    class CtorUser
+    {
+    public:
+        INJECT_CTOR(CtorUser(std::shared_ptr<FieldUser> fieldUser)) :
+            fieldUser(fieldUser)
+        {}
+        std::shared_ptr<FieldUser> fieldUser;
+    };
+
+    class TraitsUser
+    {
+    public:
+        std::shared_ptr<ICounter> counter;
+    };
+
+    class ContainerTraitsUser
+    {
+    public:
+        std::shared_ptr<ICounter> counter;
+        ICounter* single = nullptr;
+        std::shared_ptr<ICounter> transient;
+    };
+}
+
+namespace emaject
+{
+    template<>
+    struct InjectTraits<TraitsUser>
+    {
+        void onInject(TraitsUser* value, auto* c)
+        {
+            value->counter = c->template resolve<ICounter>();
+        }
+    };
+
+    // written for the runtime Container only
+    template<>
+    struct InjectTraits<ContainerTraitsUser>
+    {
+        void onInject(ContainerTraitsUser* value, Container* c)
+        {
+            value->counter = c->resolve<ICounter>();
+            value->single = c->resolveBorrowed<ICounter, 2>();
+            value->transient = c->resolve<ICounter, 1>();
+        }
+    };
+}
+
+namespace
+{
+    using Injector = StaticInjector<
+        Bind<ICounter, Counter, ScopeKind::Cached>,
+        Bind<ICounter, Counter, ScopeKind::Transient, 1>,
+        Bind<ICounter, SingleCounter, ScopeKind::Single, 2>,
+        Bind<FieldUser>
+    >;
+
+    TEST_CASE("static_injector")
+    {
+        Injector injector;
+        {
+            auto counter = injector.resolve<ICounter>(); // new instance
+            REQUIRE(counter->countUp() == 1);
+            REQUIRE(injector.resolve<ICounter>() == counter);
+            REQUIRE(injector.resolveBorrowed<ICounter>() == counter.get());
+        }
+        {
+            auto counter1 = injector.resolve<ICounter, 1>();
+            auto counter2 = injector.resolve<ICounter, 1>();
+            REQUIRE(counter1 != nullptr);
+            REQUIRE(counter1 != counter2);
+        }
+        {
+            // not bound
+            REQUIRE(injector.resolve<Counter>() == nullptr);
+        }
+        {
+            auto user = injector.instantiate<FieldUser>();
+            REQUIRE(user->counter == injector.resolve<ICounter>());
+            REQUIRE(user->transient != nullptr);
+            REQUIRE(user->transient != user->counter);
+        }
+        {
+            auto user = injector.instantiate<MethodUser>();
+            REQUIRE(user->counter == injector.resolve<ICounter>());
+            REQUIRE(user->single == injector.resolve<ICounter, 2>());
+        }
+        {
+            auto user = injector.instantiate<CtorUser>();
+            REQUIRE(user->fieldUser != nullptr);
+            REQUIRE(user->fieldUser->counter == injector.resolve<ICounter>());
+        }
+        {
+            auto user = injector.instantiate<TraitsUser>();
+            REQUIRE(user->counter == injector.resolve<ICounter>());
+        }
+        {
+            // Container* traits see the same Cached and Single instances
+            auto user = injector.instantiate<ContainerTraitsUser>();
+            REQUIRE(user->counter == injector.resolve<ICounter>());
+            REQUIRE(user->single == injector.resolveBorrowed<ICounter, 2>());
+            REQUIRE(user->transient != nullptr);
+            REQUIRE(user->transient != user->counter);
+        }
+    }
+}
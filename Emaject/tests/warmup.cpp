@@ -0,0 +1,249 @@
+#include <Emaject.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    std::atomic<int> g_constructCount = 0;
+
+    struct Slow
+    {
+        Slow()
+        {
+            ++g_constructCount;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    };
+    struct Config : Slow
+    {};
+    struct Database : Slow
+    {
+        INJECT_CTOR(Database(std::shared_ptr<Config> config)) :
+            config(config)
+        {}
+        std::shared_ptr<Config> config;
+    };
+    struct Cache : Slow
+    {
+        INJECT_CTOR(Cache(std::shared_ptr<Config> config)) :
+            config(config)
+        {}
+        std::shared_ptr<Config> config;
+    };
+    struct Service : Slow
+    {
+        INJECT_CTOR(Service(std::shared_ptr<Database> db, std::shared_ptr<Cache> cache)) :
+            db(db),
+            cache(cache)
+        {}
+        std::shared_ptr<Database> db;
+        std::shared_ptr<Cache> cache;
+    };
+
+    // two slow inputs that only finish when built at the same time, and a dependent checking they are done
+    std::atomic<int> g_building = 0;
+    std::atomic<int> g_built = 0;
+
+    struct Overlapping
+    {
+        Overlapping()
+        {
+            ++g_building;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (g_building < 2 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            overlapped = g_building >= 2;
+            ++g_built;
+        }
+        bool overlapped = false;
+    };
+    struct Storage : Overlapping
+    {};
+    struct Index : Overlapping
+    {};
+    struct Frontend
+    {
+        Frontend() :
+            startedAfterInputs(g_built == 2)
+        {}
+        [[INJECT(storage)]]
+        std::shared_ptr<Storage> storage;
+        [[INJECT(index)]]
+        std::shared_ptr<Index> index;
+
+        bool startedAfterInputs;
+    };
+
+    struct ServiceInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<Service>().asSingle();
+            c->bind<Database>().asSingle();
+            c->bind<Cache>().asCached();
+            c->bind<Config>().asSingle();
+        }
+    };
+
+    /// <summary>
+    /// Runs each task on its own thread until destroyed
+    /// </summary>
+    class ThreadExecutor
+    {
+    public:
+        ~ThreadExecutor()
+        {
+            for (auto& thread : m_threads) {
+                thread.join();
+            }
+        }
+        void operator()(std::function<void()> task)
+        {
+            // tasks submit their dependents from their own threads
+            std::lock_guard lock(m_mutex);
+            m_threads.emplace_back(std::move(task));
+        }
+    private:
+        std::mutex m_mutex;
+        std::vector<std::thread> m_threads;
+    };
+
+    /// <summary>
+    /// Fixed number of workers draining a queue
+    /// </summary>
+    class PoolExecutor
+    {
+    public:
+        explicit PoolExecutor(size_t workers)
+        {
+            for (size_t i = 0; i < workers; ++i) {
+                m_workers.emplace_back([this] {
+                    this->work();
+                });
+            }
+        }
+        ~PoolExecutor()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopped = true;
+            }
+            m_ready.notify_all();
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+        }
+        void operator()(std::function<void()> task)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+            m_ready.notify_one();
+        }
+    private:
+        void work()
+        {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_ready.wait(lock, [this] {
+                        return m_stopped || !m_tasks.empty();
+                    });
+                    if (m_tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_stopped = false;
+        std::vector<std::thread> m_workers;
+    };
+
+    TEST_CASE("warmup")
+    {
+        {
+            Injector injector;
+            injector.install<ServiceInstaller>();
+
+            g_constructCount = 0;
+            ThreadExecutor executor;
+            REQUIRE(injector.warmup(executor));
+            // shared dependencies are built once even when several tasks need them
+            REQUIRE(g_constructCount == 4);
+
+            auto service = injector.resolve<Service>();
+            REQUIRE(g_constructCount == 4);
+            REQUIRE(service->db->config == service->cache->config);
+            REQUIRE(service->cache == injector.resolve<Cache>());
+        }
+        {
+            Injector injector;
+            injector.install<ServiceInstaller>();
+
+            g_constructCount = 0;
+            REQUIRE(injector.warmup());
+            REQUIRE(g_constructCount == 4);
+        }
+        {
+            // the dependent is bound first, yet two workers are enough: it isn't submitted before its inputs are done
+            Injector injector;
+            injector.install([](Container* c) {
+                c->bind<Frontend>().asSingle();
+                c->bind<Storage>().asCached();
+                c->bind<Index>().asCached();
+            });
+            g_building = 0;
+            g_built = 0;
+            {
+                PoolExecutor executor(2);
+                REQUIRE(injector.warmup(executor));
+            }
+            auto frontend = injector.resolve<Frontend>();
+            REQUIRE(frontend->storage->overlapped);
+            REQUIRE(frontend->index->overlapped);
+            REQUIRE(frontend->startedAfterInputs);
+        }
+        {
+            Injector injector;
+            injector.install([](Container* c) {
+                c->bind<Config>().fromFactory([]() -> std::shared_ptr<Config> {
+                    throw std::runtime_error("config");
+                }).asCached();
+            });
+            ThreadExecutor executor;
+            REQUIRE_THROWS_AS(injector.warmup(executor), std::runtime_error);
+        }
+        {
+            Injector injector;
+            injector.install([](Container* c) {
+                c->bind<Cache>().fromFactory([] {
+                    return std::shared_ptr<Cache>();
+                }).asCached();
+            });
+            REQUIRE_FALSE(injector.warmup());
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include <Emaject.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    using emaject::Container;
+    using emaject::IInstaller;
+    using emaject::Injector;
+
+    size_t g_allocated = 0;
+
+    template<class T>
+    struct CountingAllocator
+    {
+        using value_type = T;
+
+        CountingAllocator() = default;
+        template<class U>
+        CountingAllocator(const CountingAllocator<U>&) noexcept
+        {}
+
+        T* allocate(size_t n)
+        {
+            ++g_allocated;
+            return std::allocator<T>{}.allocate(n);
+        }
+        void deallocate(T* p, size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+        template<class U>
+        bool operator==(const CountingAllocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    class IPrinter
+    {
+    public:
+        virtual ~IPrinter() = default;
+        virtual std::string print() const = 0;
+    };
+
+    class Printer : public IPrinter
+    {
+    public:
+        Printer() = default;
+        Printer(const std::string& text) :
+            m_text(text)
+        {}
+        std::string print() const override
+        {
+            return m_text;
+        }
+    private:
+        std::string m_text = "Printer";
+    };
+
+    class HelloWorld
+    {
+    public:
+        INJECT_CTOR(HelloWorld(std::shared_ptr<IPrinter> printer)) :
+            printer(printer)
+        {}
+        std::shared_ptr<IPrinter> printer;
+    };
+
+    struct PrinterInstaller : IInstaller
+    {
+        void onBinding(Container* c) const
+        {
+            c->bind<IPrinter>()
+                .to<Printer>()
+                .withAllocator(CountingAllocator<Printer>{})
+                .asTransient();
+
+            c->bind<IPrinter, 1>()
+                .to<Printer>()
+                .withAllocator(CountingAllocator<Printer>{})
+                .withArgs("Args")
+                .asTransient();
+
+            c->bind<HelloWorld>()
+                .withPool()
+                .asTransient();
+        }
+    };
+
+    TEST_CASE("with_allocator")
+    {
+        Injector injector;
+        injector.install<PrinterInstaller>();
+
+        g_allocated = 0;
+        {
+            auto printer = injector.resolve<IPrinter>();
+            REQUIRE(printer->print() == "Printer");
+            REQUIRE(g_allocated == 1);
+        }
+        {
+            auto printer = injector.resolve<IPrinter, 1>();
+            REQUIRE(printer->print() == "Args");
+            REQUIRE(g_allocated == 2);
+        }
+        {
+            // instances may outlive the injector that owns the pool
+            std::shared_ptr<HelloWorld> hello;
+            {
+                Injector scoped;
+                scoped.install<PrinterInstaller>();
+                hello = scoped.resolve<HelloWorld>();
+            }
+            REQUIRE(hello->printer->print() == "Printer");
+            REQUIRE(hello != injector.resolve<HelloWorld>());
+        }
+    }
+}